@@ -67,6 +67,10 @@
     #define XCP_DAQ_CONFIG_TYPE_DYNAMIC (1)
     #define XCP_DAQ_CONFIG_TYPE_NONE    (3)
 
+    #define XCP_DAQ_OVERLOAD_INDICATION_NONE  (0)
+    #define XCP_DAQ_OVERLOAD_INDICATION_PID   (1) /* MSB of the PID of the next DTO of the DAQ list. */
+    #define XCP_DAQ_OVERLOAD_INDICATION_EVENT (2) /* EV_DAQ_OVERLOAD event packet. */
+
     /*
     **  XCPonSXI Header Formats.
     */
@@ -126,30 +130,14 @@ extern "C" {
     */
 
     /* Check for unsupported features. */
-    #if XCP_ENABLE_STIM == XCP_ON
-        #error STIM not supported yet.
-    #endif /* XCP_ENABLE_STIM */
-
     #if XCP_DAQ_ENABLE_ALTERNATING == XCP_ON
         #error XCP_DAQ_ENABLE_ALTERNATING not supported yet.
     #endif /* XCP_DAQ_ENABLE_ALTERNATING */
 
-    #if XCP_DAQ_ENABLE_PRIORITIZATION == XCP_ON
-        #error DAQ priorization not supported yet.
-    #endif /* XCP_DAQ_ENABLE_PRIORITIZATION */
-
-    #if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
-        #error DAQ doesnt support bit-offsets yet.
-    #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
-
     #if XCP_DAQ_ENABLE_ADDR_EXT == XCP_ON
         #error "DAQ doesn't support address extension."
     #endif /* XCP_DAQ_ENABLE_ADDR_EXT */
 
-    #if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
-        #error Multiple DAQ lists per event are not supported yet.
-    #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
-
     #if XCP_ENABLE_MASTER_BLOCKMODE == XCP_ON
         #if XCP_ENABLE_DOWNLOAD_NEXT == XCP_OFF
             #error Master block-mode requires optional command 'downloadNext'.
@@ -383,6 +371,14 @@ extern "C" {
     #define XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE (XCP_MAX_CTO + XCP_TRANSPORT_LAYER_BUFFER_OFFSET)
     #define XCP_TRANSPORT_LAYER_DTO_BUFFER_SIZE (XCP_MAX_DTO + XCP_TRANSPORT_LAYER_BUFFER_OFFSET)
 
+    /* Incoming packets are CTOs, or STIM DTOs. */
+    #if XCP_ENABLE_STIM == XCP_ON
+        #define XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE                                                                                 \
+            (XCP_MAX(XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE, XCP_TRANSPORT_LAYER_DTO_BUFFER_SIZE))
+    #else
+        #define XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE
+    #endif /* XCP_ENABLE_STIM */
+
     #if !defined(XCP_DAQ_ENABLE_WRITE_THROUGH)
         #define XCP_DAQ_ENABLE_WRITE_THROUGH XCP_OFF
     #endif
@@ -391,6 +387,174 @@ extern "C" {
         #define XCP_DAQ_ENABLE_RESET_DYN_DAQ_CONFIG_ON_SEQUENCE_ERROR XCP_OFF
     #endif
 
+    #if !defined(XCP_DAQ_SAMPLING_PLAN_SIZE)
+        #define XCP_DAQ_SAMPLING_PLAN_SIZE (XCP_DAQ_MAX_DYNAMIC_ENTITIES)
+    #endif /* XCP_DAQ_SAMPLING_PLAN_SIZE */
+
+    #if !defined(XCP_DAQ_SAMPLING_PLAN_ODTS)
+        #define XCP_DAQ_SAMPLING_PLAN_ODTS (XCP_DAQ_SAMPLING_PLAN_SIZE)
+    #endif /* XCP_DAQ_SAMPLING_PLAN_ODTS */
+
+    #if !defined(XCP_DAQ_SAMPLING_PLAN_ENTRIES)
+        #define XCP_DAQ_SAMPLING_PLAN_ENTRIES (XCP_DAQ_SAMPLING_PLAN_SIZE)
+    #endif /* XCP_DAQ_SAMPLING_PLAN_ENTRIES */
+
+    #if !defined(XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION)
+        #define XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+
+    #if !defined(XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS)
+        #define XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+
+    #if !defined(XCP_DAQ_ENABLE_QUEUE_BUDGETS)
+        #define XCP_DAQ_ENABLE_QUEUE_BUDGETS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+
+    #if XCP_DAQ_ENABLE_PRIORITIZATION == XCP_ON
+        #if !defined(XCP_DAQ_PRIORITY_QUEUES)
+            #define XCP_DAQ_PRIORITY_QUEUES (4)
+        #endif /* XCP_DAQ_PRIORITY_QUEUES */
+        #if (XCP_DAQ_PRIORITY_QUEUES < 1) || (XCP_DAQ_PRIORITY_QUEUES > 256)
+            #error XCP_DAQ_PRIORITY_QUEUES must be in range [1 .. 256]
+        #endif
+    #else
+        #undef XCP_DAQ_PRIORITY_QUEUES
+        #define XCP_DAQ_PRIORITY_QUEUES (1)
+    #endif /* XCP_DAQ_ENABLE_PRIORITIZATION */
+
+    #if !defined(XCP_DAQ_ENABLE_SNAPSHOTS)
+        #define XCP_DAQ_ENABLE_SNAPSHOTS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+    #if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+        #if !defined(XCP_DAQ_SNAPSHOT_BUFFER_SIZE)
+            #define XCP_DAQ_SNAPSHOT_BUFFER_SIZE (XCP_MAX_DTO * 4)
+        #endif /* XCP_DAQ_SNAPSHOT_BUFFER_SIZE */
+        #if !defined(XCP_DAQ_SNAPSHOT_RETRIES)
+            #define XCP_DAQ_SNAPSHOT_RETRIES (3)
+        #endif /* XCP_DAQ_SNAPSHOT_RETRIES */
+        #if !defined(XCP_DAQ_SNAPSHOT_BACKOFF)
+            #define XCP_DAQ_SNAPSHOT_BACKOFF (64)
+        #endif /* XCP_DAQ_SNAPSHOT_BACKOFF */
+    #endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+    #if XCP_ENABLE_STIM == XCP_ON
+        #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+            #error XCP_ENABLE_STIM requires an identification field (PID)
+        #endif
+        #if !defined(XCP_DAQ_STIM_BUFFER_SIZE)
+            #define XCP_DAQ_STIM_BUFFER_SIZE (XCP_MAX_DTO * 12)
+        #endif /* XCP_DAQ_STIM_BUFFER_SIZE */
+    #endif /* XCP_ENABLE_STIM */
+
+    #if !defined(XCP_DAQ_ENABLE_EVENT_RATE_LIMITS)
+        #define XCP_DAQ_ENABLE_EVENT_RATE_LIMITS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
+    #if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+        #if !defined(XCP_DAQ_TIMESTAMP_UNIT) || !defined(XCP_DAQ_TIMESTAMP_SIZE)
+            #error XCP_DAQ_ENABLE_EVENT_RATE_LIMITS requires XCP_DAQ_TIMESTAMP_UNIT and XCP_DAQ_TIMESTAMP_SIZE
+        #endif /* !defined(XCP_DAQ_TIMESTAMP_UNIT) || !defined(XCP_DAQ_TIMESTAMP_SIZE) */
+    #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
+    #if !defined(XCP_DAQ_ENABLE_BYPASS)
+        #define XCP_DAQ_ENABLE_BYPASS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+        #if XCP_ENABLE_STIM == XCP_OFF
+            #error XCP_DAQ_ENABLE_BYPASS requires XCP_ENABLE_STIM
+        #endif /* XCP_ENABLE_STIM */
+        #if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
+            #error XCP_DAQ_ENABLE_BYPASS requires XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+
+    #if !defined(XCP_DAQ_ENABLE_ODT_PACKING)
+        #define XCP_DAQ_ENABLE_ODT_PACKING XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+    #if (XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON) && (XCP_ENABLE_USER_CMD == XCP_OFF)
+        #error XCP_DAQ_ENABLE_ODT_PACKING requires XCP_ENABLE_USER_CMD (layout is exposed to the master)
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+    #if !defined(XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT)
+        #define XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT */
+
+    #if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
+        /*
+        ** TIMESTAMP_MODE (GET_DAQ_RESOLUTION_INFO) has no code for 8 byte timestamps, so with XCP_DAQ_TIMESTAMP_SIZE_8
+        ** DTOs carry -- and the master is told about -- the lower 4 bytes of the 64-bit time base.
+        */
+        #define XCP_DAQ_DTO_TIMESTAMP_SIZE XCP_MIN(XCP_DAQ_TIMESTAMP_SIZE, XCP_DAQ_TIMESTAMP_SIZE_4)
+        #define XCP_DAQ_TIMESTAMP_MODE     ((XCP_DAQ_TIMESTAMP_UNIT << 4) | XCP_DAQ_DTO_TIMESTAMP_SIZE)
+    #else
+        #define XCP_DAQ_TIMESTAMP_MODE (0x00)
+    #endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
+
+    #if !defined(XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS)
+        #define XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+        #define XCP_DAQ_LATENCY_BUCKETS   (33)         /* 0 ticks, then one per power of two of a 32-bit timer. */
+        #define XCP_DAQ_LATENCY_TRANSPORT UINT8(0xff) /* Source of GET_DAQ_LATENCIES: transport layer. */
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
+    #if !defined(XCP_DAQ_ENABLE_ASYNC_SAMPLING)
+        #define XCP_DAQ_ENABLE_ASYNC_SAMPLING XCP_OFF
+    #endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
+    #if !defined(XCP_DAQ_TRANSMIT_BATCH_SIZE)
+        #define XCP_DAQ_TRANSMIT_BATCH_SIZE (1) /* DTOs handed to the transport layer at once (XcpTl_SendBatch()). */
+    #endif                                      /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
+    #if !defined(XCP_DAQ_OVERLOAD_INDICATION)
+        #define XCP_DAQ_OVERLOAD_INDICATION XCP_DAQ_OVERLOAD_INDICATION_NONE
+    #endif /* XCP_DAQ_OVERLOAD_INDICATION */
+
+    #if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+        #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+            #error XCP_DAQ_OVERLOAD_INDICATION_PID requires an identification field (PID)
+        #endif
+    #elif XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+        #if XCP_ENABLE_EVENT_PACKET_API == XCP_OFF
+            #error XCP_DAQ_OVERLOAD_INDICATION_EVENT requires XCP_ENABLE_EVENT_PACKET_API
+        #endif /* XCP_ENABLE_EVENT_PACKET_API */
+    #elif XCP_DAQ_OVERLOAD_INDICATION != XCP_DAQ_OVERLOAD_INDICATION_NONE
+        #error Unknown XCP_DAQ_OVERLOAD_INDICATION value.
+    #endif /* XCP_DAQ_OVERLOAD_INDICATION */
+
+    #if (XCP_ENABLE_DAQ_COMMANDS == XCP_ON) && defined(XCP_DAQ_QUEUE_SIZE)
+        #if (XCP_DAQ_QUEUE_SIZE < 2) || (XCP_DAQ_QUEUE_SIZE > 0x80000000UL) ||                                                       \
+            ((XCP_DAQ_QUEUE_SIZE & (XCP_DAQ_QUEUE_SIZE - 1)) != 0)
+            #error XCP_DAQ_QUEUE_SIZE must be a power of two in range [2 .. 2**31]
+        #endif
+        /* DTOs per priority queue, the queues share the XCP_DAQ_QUEUE_SIZE slots. */
+        #if !defined(XCP_DAQ_PRIORITY_QUEUE_SIZE)
+            #define XCP_DAQ_PRIORITY_QUEUE_SIZE (XCP_DAQ_QUEUE_SIZE / XCP_DAQ_PRIORITY_QUEUES)
+        #endif /* XCP_DAQ_PRIORITY_QUEUE_SIZE */
+        #if (XCP_DAQ_PRIORITY_QUEUE_SIZE < 2) || ((XCP_DAQ_PRIORITY_QUEUE_SIZE & (XCP_DAQ_PRIORITY_QUEUE_SIZE - 1)) != 0)
+            #error XCP_DAQ_PRIORITY_QUEUE_SIZE must be a power of two >= 2, define it to split XCP_DAQ_QUEUE_SIZE unevenly
+        #endif
+        #if (XCP_DAQ_PRIORITY_QUEUE_SIZE * XCP_DAQ_PRIORITY_QUEUES) > XCP_DAQ_QUEUE_SIZE
+            #error XCP_DAQ_PRIORITY_QUEUES * XCP_DAQ_PRIORITY_QUEUE_SIZE must not exceed XCP_DAQ_QUEUE_SIZE
+        #endif
+    #endif /* XCP_DAQ_QUEUE_SIZE */
+
+    /* Queue indices are free-running, so they need one bit more than required to address a slot. */
+    #if !defined(XCP_DAQ_QUEUE_INDEX_TYPE)
+        #if !defined(XCP_DAQ_QUEUE_SIZE) || (XCP_DAQ_QUEUE_SIZE <= 128)
+            #define XCP_DAQ_QUEUE_INDEX_TYPE uint8_t
+        #elif XCP_DAQ_QUEUE_SIZE <= 32768
+            #define XCP_DAQ_QUEUE_INDEX_TYPE uint16_t
+        #else
+            #define XCP_DAQ_QUEUE_INDEX_TYPE uint32_t
+        #endif
+    #endif /* XCP_DAQ_QUEUE_INDEX_TYPE */
+
     #if XCP_DAQ_MAX_DYNAMIC_ENTITIES < 256
         #define XCP_DAQ_ENTITY_TYPE uint8_t
     #elif XCP_DAQ_MAX_DYNAMIC_ENTITIES < 65536
@@ -399,6 +563,18 @@ extern "C" {
         #define XCP_DAQ_ENTITY_TYPE uint32_t
     #endif
 
+    #define XCP_DAQ_NO_LIST          ((XcpDaq_ListIntegerType)~(XcpDaq_ListIntegerType)0)
+    #define XCP_DAQ_NO_EVENT_CHANNEL UINT16(0xffff)
+    #define XCP_DAQ_NO_BIT_OFFSET    UINT8(0xff) /* Entry isn't a single bit. */
+    #define XCP_DAQ_MAX_BIT_OFFSET   UINT8(0x1f)
+
+    /*
+    ** Sub-commands of USER_CMD (vendor extensions).
+    */
+    #define XCP_USER_CMD_SET_DAQ_PACKING        UINT8(0x01)
+    #define XCP_USER_CMD_GET_DAQ_ENTRY_POSITION UINT8(0x02)
+    #define XCP_USER_CMD_GET_DAQ_LATENCIES      UINT8(0x03)
+
     #define XCP_DAQ_LISTS_STOP_ALL       UINT8(0x00)
     #define XCP_DAQ_LISTS_START_SELECTED UINT8(0x01)
     #define XCP_DAQ_LISTS_STOP_SELECTED  UINT8(0x02)
@@ -518,8 +694,9 @@ extern "C" {
     #define XCP_DAQ_KEY_OPTIMISATION_TYPE_0         UINT8(0x01)
 
     /* DAQ Event Channel Properties */
-    #define XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ  UINT8(0x04)
-    #define XCP_DAQ_EVENT_CHANNEL_TYPE_STIM UINT8(0x08)
+    #define XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ      UINT8(0x04)
+    #define XCP_DAQ_EVENT_CHANNEL_TYPE_STIM     UINT8(0x08)
+    #define XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM UINT8(0x0c) /* Bypassing. */
 
     /* DAQ Consistency */
     #define XCP_DAQ_CONSISTENCY_DAQ_LIST      UINT8(0x40)
@@ -633,10 +810,19 @@ extern "C" {
     #define XCP_DAQ_END_EVENTS                                                                                                     \
         }                                                                                                                          \
         ;
-    #define XCP_DAQ_DEFINE_EVENT(name, props, timebase, cycle)                                                                     \
-        {                                                                                                                          \
-            (uint8_t const * const)(name), sizeof((name)) - 1, (props), (timebase), (cycle),                                       \
-        }
+    #if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+        #define XCP_DAQ_DEFINE_EVENT(name, props, timebase, cycle)                                                                 \
+            XCP_DAQ_DEFINE_RATE_LIMITED_EVENT(name, props, timebase, cycle, 1, 0)
+        #define XCP_DAQ_DEFINE_RATE_LIMITED_EVENT(name, props, timebase, cycle, prescaler, minInterval)                            \
+            {                                                                                                                      \
+                (uint8_t const * const)(name), sizeof((name)) - 1, (props), (timebase), (cycle), (prescaler), (minInterval),       \
+            }
+    #else
+        #define XCP_DAQ_DEFINE_EVENT(name, props, timebase, cycle)                                                                 \
+            {                                                                                                                      \
+                (uint8_t const * const)(name), sizeof((name)) - 1, (props), (timebase), (cycle),                                   \
+            }
+    #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
 
     #define XCP_DAQ_BEGIN_ID_LIST const uint32_t Xcp_DaqIDs[] = {
     #define XCP_DAQ_END_ID_LIST                                                                                                    \
@@ -1028,6 +1214,12 @@ extern "C" {
         uint8_t *data;
     } Xcp_PduType;
 
+    /* Framed message (transport layer header included), see XcpTl_SendBatch(). */
+    typedef struct tagXcpTl_FrameType {
+        uint8_t const *data;
+        uint16_t       len;
+    } XcpTl_FrameType;
+
     typedef struct tagXcp_GetIdType {
         uint16_t       len;
         uint8_t const *name;
@@ -1037,7 +1229,7 @@ extern "C" {
     typedef struct tagXcpDaq_ODTEntryType {
         XcpDaq_MtaType mta;
         #if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
-        uint8_t bitOffset;
+        uint8_t bitOffset; /* 0..31: Single bit of the 32-bit word at mta (length 1), else XCP_DAQ_NO_BIT_OFFSET. */
         #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
         uint32_t length;
     } XcpDaq_ODTEntryType;
@@ -1059,29 +1251,30 @@ extern "C" {
         uint32_t       length;
     } XcpDaq_MeasurementVariable;
 
-    typedef struct tagXcpDaq_DynamicListType {
-        XcpDaq_ODTIntegerType numOdts;
-        uint16_t              firstOdt;
-        uint8_t               mode;
-        #if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
-        uint8_t prescaler;
-        uint8_t counter;
-        #endif /* XCP_DAQ_ENABLE_PRESCALER */
-    } XcpDaq_DynamicListType;
-
     typedef struct tagXcpDaq_ListConfigurationType {
         XcpDaq_ODTIntegerType numOdts;
         uint16_t              firstOdt;
     } XcpDaq_ListConfigurationType;
 
     typedef struct tagXcpDaq_ListStateType {
-        uint8_t mode;
+        uint8_t               mode;
+        uint8_t               priority;
+        XcpDaq_ODTIntegerType firstPid;     /* Absolute number of first ODT. */
+        uint16_t              eventChannel; /* XCP_DAQ_NO_EVENT_CHANNEL if not assigned. */
         #if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
         uint8_t prescaler;
         uint8_t counter;
         #endif /* XCP_DAQ_ENABLE_PRESCALER */
+        #if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+        bool overload; /* Samples were lost, flag the next DTO. */
+        #endif /* XCP_DAQ_OVERLOAD_INDICATION */
     } XcpDaq_ListStateType;
 
+    typedef struct tagXcpDaq_DynamicListType {
+        XcpDaq_ODTIntegerType numOdts;
+        uint16_t              firstOdt;
+    } XcpDaq_DynamicListType;
+
     typedef enum tagXcpDaq_EntityKindType {
         XCP_ENTITY_UNUSED,
         XCP_ENTITY_DAQ_LIST,
@@ -1100,12 +1293,42 @@ extern "C" {
         } entity;
     } XcpDaq_EntityType;
 
+    typedef struct tagXcpDaq_PlanStatisticsType {
+        uint16_t entries;          /* ODT entries of all compiled DAQ lists. */
+        uint16_t runs;             /* Memory copies (or bit extractions) per complete sampling. */
+        uint16_t copiesEliminated; /* Entries merged into address-adjacent predecessors, incl. bits of the same byte. */
+        uint16_t duplicateEntries; /* Entries already sampled by another ODT of the same list. */
+    } XcpDaq_PlanStatisticsType;
+
+    /* Round trips (DAQ out, STIM back) of a bypass event, times in units of XcpHw_GetTimerCounter(). */
+    typedef struct tagXcpDaq_BypassStatisticsType {
+        uint32_t cycles;          /* STIM data received in time. */
+        uint32_t missedDeadlines; /* STIM data not (completely) received by the next occurrence of the event. */
+        uint32_t latency;         /* Last round trip, from sampling to reception of the STIM data. */
+        uint32_t minLatency;
+        uint32_t maxLatency;
+    } XcpDaq_BypassStatisticsType;
+
+        #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    /*
+    ** log2 histogram of latencies in units of XcpHw_GetTimerCounter(): bucket 0 counts
+    ** latencies of 0 ticks, bucket n those of [2**(n-1) .. 2**n - 1] ticks.
+    */
+    typedef struct tagXcpDaq_LatencyHistogramType {
+        uint32_t buckets[XCP_DAQ_LATENCY_BUCKETS];
+    } XcpDaq_LatencyHistogramType;
+        #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
     typedef struct tagXcpDaq_EventType {
         uint8_t const * const name;
         uint8_t               nameLen;
         uint8_t               properties;
         uint8_t               timeunit;
         uint8_t               cycle;
+        #if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+        uint8_t  prescaler;   /* Only every n-th occurrence is processed (0, 1: each). */
+        uint32_t minInterval; /* Min. time between processed occurrences in units of XcpHw_GetTimerCounter() (0: none). */
+        #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
         /* unit8_t priority; */
     } XcpDaq_EventType;
 
@@ -1129,6 +1352,8 @@ extern "C" {
 
     typedef void (*Xcp_SendCalloutType)(Xcp_PduType const *pdu);
 
+    typedef void (*XcpDaq_WorkerCalloutType)(void);
+
     typedef void (*Xcp_ServerCommandType)(Xcp_PduType const * const pdu);
 
     typedef struct tagXcp_1DArrayType {
@@ -1225,14 +1450,32 @@ extern "C" {
         XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType odtNumber, XcpDaq_ODTEntryIntegerType odtEntry
     );
 
+    bool XcpDaq_ValidateEntrySize(uint8_t elemSize);
+
+    bool XcpDaq_ValidateListSize(XcpDaq_ListIntegerType daqListNumber, uint8_t mode);
+
     void XcpDaq_AddEventChannel(XcpDaq_ListIntegerType daqListNumber, uint16_t eventChannelNumber);
 
     void XcpDaq_CopyMemory(void *dst, void const *src, uint32_t len);
 
     XcpDaq_EventType const *XcpDaq_GetEventConfiguration(uint16_t eventChannelNumber);
 
+        #if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+    void XcpDaq_GetEffectiveEventCycle(uint16_t eventChannelNumber, uint8_t *cycle, uint8_t *timeunit);
+        #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
     void XcpDaq_TriggerEvent(uint8_t eventChannelNumber);
 
+    void XcpDaq_TriggerEvents(uint8_t const *eventChannelNumbers, uint8_t count);
+
+        #if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    void XcpDaq_SetAsyncSampling(uint8_t eventChannelNumber, bool async);
+
+    void XcpDaq_SetWorkerCallout(XcpDaq_WorkerCalloutType callout);
+
+    bool XcpDaq_ProcessEvents(void);
+        #endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
     void XcpDaq_GetProperties(uint8_t *properties);
 
     XcpDaq_ListIntegerType XcpDaq_GetListCount(void);
@@ -1245,12 +1488,33 @@ extern "C" {
 
     void XcpDaq_StopAllLists(void);
 
-    void XcpDaq_StartStopSingleList(XcpDaq_ListIntegerType daqListNumber, uint8_t mode);
+    Xcp_ReturnType XcpDaq_StartStopSingleList(XcpDaq_ListIntegerType daqListNumber, uint8_t mode);
 
-    void XcpDaq_StartStopSynch(uint8_t mode);
+    Xcp_ReturnType XcpDaq_StartStopSynch(uint8_t mode);
 
     bool XcpDaq_GetFirstPid(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType *firstPID);
 
+    void XcpDaq_GetPlanStatistics(XcpDaq_PlanStatisticsType *statistics);
+
+        #if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+    Xcp_ReturnType XcpDaq_SetListPacking(XcpDaq_ListIntegerType daqListNumber, bool packed);
+
+    bool XcpDaq_GetEntryPosition(
+        XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType odtNumber, XcpDaq_ODTEntryIntegerType odtEntryNumber,
+        XcpDaq_ODTIntegerType *pid, uint16_t *offset
+    );
+        #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+        #if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    void XcpDaq_UpdateBegin(void);
+
+    void XcpDaq_UpdateEnd(void);
+        #endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+        #if XCP_ENABLE_STIM == XCP_ON
+    void XcpDaq_StimReceive(uint8_t const *dto, uint16_t len);
+        #endif /* XCP_ENABLE_STIM */
+
     void XcpDaq_SetPointer(
         XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType odtNumber, XcpDaq_ODTEntryIntegerType odtEntryNumber
     );
@@ -1277,6 +1541,20 @@ extern "C" {
 
     extern const XcpDaq_EventType XcpDaq_Events[];
 
+    /* Number of samples (DAQ list cycles) of which at least one ODT was lost. */
+    extern uint32_t XcpDaq_ListLostSamples[];
+    extern uint32_t XcpDaq_EventLostSamples[];
+
+        #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    extern XcpDaq_BypassStatisticsType XcpDaq_BypassStatistics[];
+        #endif /* XCP_DAQ_ENABLE_BYPASS */
+
+        #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    /* Only updated by the transmitter, so they can be read (approximately) without locking. */
+    extern XcpDaq_LatencyHistogramType XcpDaq_EventLatencies[];    /* From event to dequeuing of the DTO. */
+    extern XcpDaq_LatencyHistogramType XcpDaq_TransportLatencies; /* From dequeuing until XcpTl_Send[Batch]() returns. */
+        #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
     XCP_DAQ_ENTITY_TYPE XcpDaq_GetDynamicDaqEntityCount(void);
 
         #if XCP_DAQ_ENABLE_QUEUING == XCP_ON
@@ -1286,21 +1564,31 @@ extern "C" {
     */
 
     typedef struct tagXcpDaq_QueueType {
-        uint8_t head;
-        uint8_t tail;
-        bool    overload;
+        XCP_DAQ_QUEUE_INDEX_TYPE head;
+        XCP_DAQ_QUEUE_INDEX_TYPE tail;
+        bool                     overload;
     } XcpDaq_QueueType;
 
     void            XcpDaq_QueueGetVar(XcpDaq_QueueType *var);
     void            XcpDaq_QueueInit(void);
     XCP_STATIC bool XcpDaq_QueueFull(void);
     bool            XcpDaq_QueueEmpty(void);
+    uint8_t        *XcpDaq_QueueReserve(void);
+    void            XcpDaq_QueueRelease(void);
+            #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+    void                     XcpDaq_SetListQueueBudget(XcpDaq_ListIntegerType daqListNumber, XCP_DAQ_QUEUE_INDEX_TYPE budget);
+    XCP_DAQ_QUEUE_INDEX_TYPE XcpDaq_GetListQueueUsage(XcpDaq_ListIntegerType daqListNumber);
+            #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
             #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-    bool XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data, uint32_t *can_id);
-    bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data, uint32_t can_id);
+    bool     XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data, uint32_t *can_id);
+    bool     XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data, uint32_t can_id);
+    void     XcpDaq_QueueCommit(uint8_t *dto, uint16_t len, uint32_t can_id);
+    uint8_t *XcpDaq_QueuePeek(uint16_t *len, uint32_t *can_id);
             #else
-    bool XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data);
-    bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data);
+    bool     XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data);
+    bool     XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data);
+    void     XcpDaq_QueueCommit(uint8_t *dto, uint16_t len);
+    uint8_t *XcpDaq_QueuePeek(uint16_t *len);
             #endif
 
         #endif /* XCP_DAQ_ENABLE_QUEUING */
@@ -1364,6 +1652,7 @@ extern "C" {
     #define XCP_DAQ_TIMESTAMP_SIZE_1 (1)
     #define XCP_DAQ_TIMESTAMP_SIZE_2 (2)
     #define XCP_DAQ_TIMESTAMP_SIZE_4 (4)
+    #define XCP_DAQ_TIMESTAMP_SIZE_8 (8) /* 64-bit time base, DTOs carry 4 bytes (see XCP_DAQ_DTO_TIMESTAMP_SIZE). */
 
     /*
     **
@@ -1379,6 +1668,9 @@ extern "C" {
         #endif
 
     void Xcp_SendDto(void);
+    void Xcp_SendDtoBuffer(uint8_t *dto, uint16_t len);
+
+    uint16_t Xcp_FrameDto(uint8_t *dto, uint16_t len);
 
     uint8_t *Xcp_GetDtoOutPtr(void);
 
@@ -1437,8 +1729,18 @@ extern "C" {
 
     void XcpTl_Send(uint8_t const *buf, uint16_t len);
 
+    #if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+    void XcpTl_SendBatch(XcpTl_FrameType const *frames, uint16_t count);
+
+    void XcpTl_SendPending(void);
+    #endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
     void XcpTl_MainFunction(void);
 
+    #if (XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET) && defined(__linux__)
+    void XcpTl_Wakeup(void);
+    #endif /* (XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET) && defined(__linux__) */
+
     void XcpTl_SaveConnection(void);
 
     void XcpTl_ReleaseConnection(void);
@@ -1469,6 +1771,8 @@ extern "C" {
 
     uint32_t XcpHw_GetTimerCounter(void);
 
+    uint64_t XcpHw_GetTimerCounter64(void);
+
     uint32_t XcpHw_GetTimerCounterMS(void);
 
     void XcpHw_AcquireLock(uint8_t lockIdx);
@@ -45,6 +45,12 @@
         #include <unistd.h>
     #endif
 
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+        #include <sys/eventfd.h>
+        #include <sys/timerfd.h>
+    #endif
+
     #if defined(_WIN32)
 typedef struct tagXcpTl_ConnectionType {
     SOCKADDR_STORAGE connectionAddress;
@@ -66,6 +72,9 @@ typedef struct tagXcpTl_ConnectionType {
     int                     connectedSocket;
     int                     multicastSocket;
     int                     discoverySocket;
+    int                     pollFd;  /* Linux: epoll instance of the event loop. */
+    int                     eventFd; /* Linux: wakes the event loop up (shutdown, pending transmissions). */
+    int                     timerFd; /* Linux: expires XCP_ETH_FLUSH_TIME us after packing started. */
     bool                    connected;
     int                     socketType;
 } XcpTl_ConnectionType;
@@ -77,6 +86,13 @@ typedef struct tagXcpTl_ConnectionType {
         #define ZeroMemory(b, l) memset((b), 0, (l))
     #endif
 
+    /* Linux: the event loop only reads if epoll reported readiness, a spurious wakeup shall not block. */
+    #if defined(__linux__)
+        #define XCP_ETH_RECV_FLAGS MSG_DONTWAIT
+    #else
+        #define XCP_ETH_RECV_FLAGS 0
+    #endif
+
     #ifndef XCP_ENABLE_ETH_DISCOVERY
         #define XCP_ENABLE_ETH_DISCOVERY XCP_ON
     #endif
@@ -101,10 +117,28 @@ typedef struct tagXcpTl_ConnectionType {
         #define XCP_ETH_DISCOVERY_SET_IP_STATUS (2u) /* 0=valid, 1=will activate, 2=manual action required */
     #endif
 
+    /* Packing of several DTOs into one UDP datagram / TCP write, requires XCP_DAQ_TRANSMIT_BATCH_SIZE > 1. */
+    #ifndef XCP_ETH_PACKET_SIZE
+        #define XCP_ETH_PACKET_SIZE (0u) /* Max. size of a packed datagram, e.g. 1472 (MTU 1500); 0: no packing. */
+    #endif
+    #ifndef XCP_ETH_FLUSH_TIME
+        #define XCP_ETH_FLUSH_TIME (1000u) /* Max. time in us a DTO is held back for packing. */
+    #endif
+
 uint16_t XcpTl_GetLocalPort(void);
 void     XcpTl_GetLocalIpv4(uint8_t out_ip[4]);
 uint8_t  XcpTl_BuildStatus(bool extended);
 void     XcpTl_SendUdpResponse(const char *mcast_ip, uint16_t port, uint8_t const *payload, size_t len);
 bool     XcpTl_HandleTransportMulticastPacket(const uint8_t *buf, size_t len);
+void     XcpTl_Transmit(uint8_t const *buf, uint16_t len);
+int      XcpTl_ReceiveMessage(void);
+
+    #if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+void XcpTl_PackFrames(XcpTl_FrameType const *frames, uint16_t count);
+void XcpTl_FlushPacked(bool force);
+        #if defined(__linux__)
+void XcpTl_ArmFlushTimer(void);
+        #endif /* __linux__ */
+    #endif     /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
 
 #endif /* __XCP_ETH_H */
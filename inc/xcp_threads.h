@@ -36,5 +36,6 @@ void XcpThrd_EnableAsyncCancellation(void);
 void *Xcp_Thread(void *param);
 void *XcpTerm_Thread(void *param);
 void *XcpTl_Thread(void *param);
+void *XcpDaq_Thread(void *param);
 
 #endif /* __XCP_THREADS_H */
@@ -54,6 +54,10 @@ uint32_t XcpHw_GetTimerCounter(void) {
 #endif  // XCP_DAQ_TIMESTAMP_UNIT
 }
 
+uint64_t XcpHw_GetTimerCounter64(void) {
+    return (uint64_t)XcpHw_GetTimerCounter(); /* Arduino timers are 32 bits wide. */
+}
+
 uint32_t XcpHw_GetTimerCounterMS(void) {
     return millis();
 }
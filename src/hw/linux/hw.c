@@ -251,7 +251,7 @@ uint32_t XcpHw_GetTimerCounter(void) {
     timestamp &= TIMER_MASK_1;
 #elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_2
     timestamp &= TIMER_MASK_2;
-#elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4
+#elif (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4) || (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_8)
     timestamp &= TIMER_MASK_4;
 #else
     #error Timestamp-size not supported.
@@ -260,6 +260,10 @@ uint32_t XcpHw_GetTimerCounter(void) {
     return (uint32_t)timestamp;
 }
 
+uint64_t XcpHw_GetTimerCounter64(void) {
+    return XcpHw_GetElapsedTime(XCP_HW_TIMER_PRESCALER);
+}
+
 uint32_t XcpHw_GetTimerCounterMS(void) {
     uint64_t timestamp = XcpHw_GetElapsedTime(TIMER_PS_1MS);
 
@@ -169,7 +169,7 @@ uint32_t XcpHw_GetTimerCounter(void) {
     timestamp &= 0x000000FFULL;
 #elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_2
     timestamp &= 0x0000FFFFULL;
-#elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4
+#elif (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4) || (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_8)
     timestamp &= 0xFFFFFFFFULL;
 #else
     #error Timestamp-size not supported.
@@ -178,6 +178,10 @@ uint32_t XcpHw_GetTimerCounter(void) {
     return (uint32_t)timestamp;
 }
 
+uint64_t XcpHw_GetTimerCounter64(void) {
+    return XcpHw_GetElapsedTime(XCP_HW_TIMER_PRESCALER);
+}
+
 uint32_t XcpHw_GetTimerCounterMS(void) {
     uint64_t timestamp = XcpHw_GetElapsedTime(TIMER_PS_1MS);
     return (uint32_t)(timestamp & 0xFFFFFFFFULL);
@@ -80,33 +80,37 @@ void XcpHw_Deinit(void) {
     XcpHw_DeinitLocks();
 }
 
-uint32_t XcpHw_GetTimerCounter(void) {
+uint64_t XcpHw_GetTimerCounter64(void) {
     uint64_t us = time_us_64();
 #if XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1NS
-    return (uint32_t)(us * 1000ULL);
+    return us * 1000ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10NS
-    return (uint32_t)(us * 100ULL);
+    return us * 100ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100NS
-    return (uint32_t)(us * 10ULL);
+    return us * 10ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1US
-    return (uint32_t)(us);
+    return us;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10US
-    return (uint32_t)(us / 10ULL);
+    return us / 10ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100US
-    return (uint32_t)(us / 100ULL);
+    return us / 100ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1MS
-    return (uint32_t)(us / 1000ULL);
+    return us / 1000ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10MS
-    return (uint32_t)(us / 10000ULL);
+    return us / 10000ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100MS
-    return (uint32_t)(us / 100000ULL);
+    return us / 100000ULL;
 #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1S
-    return (uint32_t)(us / 1000000ULL);
+    return us / 1000000ULL;
 #else
     #error Timestamp-unit not supported.
 #endif  // XCP_DAQ_TIMESTAMP_UNIT
 }
 
+uint32_t XcpHw_GetTimerCounter(void) {
+    return (uint32_t)XcpHw_GetTimerCounter64();
+}
+
 uint32_t XcpHw_GetTimerCounterMS(void) {
     return XcpHw_GetMs32();
 }
@@ -63,6 +63,9 @@ void        FlsEmu_Info(void);
 void        Xcp_DisplayInfo(void);
 void        XcpDaq_PrintDAQDetails(void);
 void        XcpDaq_Info(void);
+#if (XCP_ENABLE_DAQ_COMMANDS == XCP_ON) && (XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON)
+static void XcpDaq_PrintLatencies(XcpDaq_LatencyHistogramType const *histogram);
+#endif /* (XCP_ENABLE_DAQ_COMMANDS == XCP_ON) && (XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON) */
 
 #if defined(_WIN32)
 void *XcpTerm_Thread(void *param) {
@@ -414,7 +417,10 @@ void XcpDaq_PrintDAQDetails(void) {
 }
 
 void XcpDaq_Info(void) {
-    Xcp_StateType const *Xcp_State;
+    Xcp_StateType const      *Xcp_State;
+    XcpDaq_PlanStatisticsType planStatistics;
+    XcpDaq_ListIntegerType    listIdx;
+    uint16_t                  eventIdx;
 
     Xcp_State = Xcp_GetState();
 
@@ -442,9 +448,57 @@ void XcpDaq_Info(void) {
         #if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
     printf("Allocated DAQ entities: %d of %d\n\r", XcpDaq_GetDynamicDaqEntityCount(), XCP_DAQ_MAX_DYNAMIC_ENTITIES);
         #endif /* XCP_DAQ_ENABLE_DYNAMIC_LISTS */
+    XcpDaq_GetPlanStatistics(&planStatistics);
+    printf(
+        "Sampling plan         : %d entries in %d copies (%d merged, %d duplicates)\n\r", planStatistics.entries,
+        planStatistics.runs, planStatistics.copiesEliminated, planStatistics.duplicateEntries
+    );
+    printf("Lost samples          :");
+    for (eventIdx = 0; eventIdx < XCP_DAQ_MAX_EVENT_CHANNEL; ++eventIdx) {
+        printf(" event #%d: %u", eventIdx, XcpDaq_EventLostSamples[eventIdx]);
+    }
+    for (listIdx = 0; (listIdx < XcpDaq_GetListCount()) && (listIdx < XCP_DAQ_SAMPLING_PLAN_SIZE); ++listIdx) {
+        printf(" list #%d: %u", listIdx, XcpDaq_ListLostSamples[listIdx]);
+    }
+    printf("\n\r");
+        #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    for (eventIdx = 0; eventIdx < XCP_DAQ_MAX_EVENT_CHANNEL; ++eventIdx) {
+        if ((XcpDaq_Events[eventIdx].properties & XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM) != XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM) {
+            continue;
+        }
+        printf(
+            "Bypass event #%-2d      : %u round trips, %u missed deadlines, latency %u [%u .. %u] ticks\n\r", eventIdx,
+            XcpDaq_BypassStatistics[eventIdx].cycles, XcpDaq_BypassStatistics[eventIdx].missedDeadlines,
+            XcpDaq_BypassStatistics[eventIdx].latency, XcpDaq_BypassStatistics[eventIdx].minLatency,
+            XcpDaq_BypassStatistics[eventIdx].maxLatency
+        );
+    }
+        #endif /* XCP_DAQ_ENABLE_BYPASS */
+        #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    for (eventIdx = 0; eventIdx < XCP_DAQ_MAX_EVENT_CHANNEL; ++eventIdx) {
+        printf("Latency event #%-2d     :", eventIdx);
+        XcpDaq_PrintLatencies(&XcpDaq_EventLatencies[eventIdx]);
+    }
+    printf("Latency transport     :");
+    XcpDaq_PrintLatencies(&XcpDaq_TransportLatencies);
+        #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
 
     #else
     printf("\tfunctionality not supported.\n\r");
     #endif
 }
+
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+/* Non-empty buckets as `< upper bound: count`, in ticks of XcpHw_GetTimerCounter(). */
+static void XcpDaq_PrintLatencies(XcpDaq_LatencyHistogramType const *histogram) {
+    uint8_t bucket;
+
+    for (bucket = 0; bucket < XCP_DAQ_LATENCY_BUCKETS; ++bucket) {
+        if (histogram->buckets[bucket] != 0) {
+            printf(" <%llu: %u", 1ULL << bucket, histogram->buckets[bucket]);
+        }
+    }
+    printf(" [ticks]\n\r");
+}
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
 #endif /* XCP_ENABLE_DAQ_COMMANDS */
@@ -61,8 +61,9 @@ typedef bool atomic_bool;
 #define UI_THREAD  (1)
 #define APP_THREAD (2)
 #define TL_THREAD  (3)
+#define DAQ_THREAD (4)
 
-#define NUM_THREADS (4)
+#define NUM_THREADS (5)
 
 typedef void *(*XcpThrd_ThreadFuncType)(void *);
 
@@ -86,6 +87,35 @@ static atomic_bool XcpThrd_ShuttingDown;
 
 void bye(void);
 
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+/*
+** Wake-up of the idle DAQ worker. Event contexts only pay for a fence and a load while the worker is busy;
+** XcpThrd_DaqIdle is announced before the worker re-checks the event ring, so no occurrence is missed.
+*/
+    #if defined(_WIN32)
+static HANDLE        XcpThrd_DaqWakeup;
+static volatile LONG XcpThrd_DaqIdle;
+
+        #define XcpThrd_DaqIdleSet()   ((void)InterlockedExchange(&XcpThrd_DaqIdle, 1))
+        #define XcpThrd_DaqIdleClaim() (InterlockedExchange(&XcpThrd_DaqIdle, 0) != 0)
+        #define XcpThrd_DaqIdlePeek()  (MemoryBarrier(), (XcpThrd_DaqIdle != 0))
+    #else
+static pthread_mutex_t XcpThrd_DaqMutex    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  XcpThrd_DaqWakeup   = PTHREAD_COND_INITIALIZER;
+static bool            XcpThrd_DaqSignaled = false; /* Guarded by XcpThrd_DaqMutex. */
+static atomic_bool     XcpThrd_DaqIdle;
+
+        #define XcpThrd_DaqIdleSet()   (atomic_store(&XcpThrd_DaqIdle, true), atomic_thread_fence(memory_order_seq_cst))
+        #define XcpThrd_DaqIdleClaim() atomic_exchange(&XcpThrd_DaqIdle, false)
+        #define XcpThrd_DaqIdlePeek()                                                                                              \
+            (atomic_thread_fence(memory_order_seq_cst), atomic_load_explicit(&XcpThrd_DaqIdle, memory_order_relaxed))
+    #endif /* _WIN32 */
+
+static void XcpThrd_SignalDaqWorker(void);
+static void XcpThrd_WakeDaqWorker(void);
+static void XcpThrd_WaitForDaqEvents(void);
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
 #if defined(_WIN32)
 static unsigned __stdcall XcpThrd_WinTrampoline(void *arg) {
     XcpThrd_ThreadFuncType func = (XcpThrd_ThreadFuncType)arg;
@@ -121,6 +151,16 @@ void XcpThrd_RunThreads(void) {
     XcpThrd_CreateThread(&threads[UI_THREAD], XcpTerm_Thread);
     XcpThrd_CreateThread(&threads[TL_THREAD], XcpTl_Thread);
     XcpThrd_CreateThread(&threads[XCP_THREAD], Xcp_Thread);
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    #if defined(_WIN32)
+    XcpThrd_DaqWakeup = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (XcpThrd_DaqWakeup == NULL) {
+        XcpHw_ErrorMsg("CreateEvent()", GetLastError());
+    }
+    #endif /* _WIN32 */
+    XcpDaq_SetWorkerCallout(XcpThrd_WakeDaqWorker);
+    XcpThrd_CreateThread(&threads[DAQ_THREAD], XcpDaq_Thread);
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 #if defined(_WIN32)
     WaitForSingleObject(threads[UI_THREAD], INFINITE);
     XcpThrd_ShutDown();
@@ -131,12 +171,20 @@ void XcpThrd_RunThreads(void) {
     if (threads[XCP_THREAD]) {
         WaitForSingleObject(threads[XCP_THREAD], INFINITE);
     }
+    #if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    if (threads[DAQ_THREAD]) {
+        WaitForSingleObject(threads[DAQ_THREAD], INFINITE);
+    }
+    #endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 #else
     pthread_join(threads[UI_THREAD], NULL);
     XcpThrd_ShutDown();
     /* Warte auf die anderen Threads */
     pthread_join(threads[TL_THREAD], NULL);
     pthread_join(threads[XCP_THREAD], NULL);
+    #if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    pthread_join(threads[DAQ_THREAD], NULL);
+    #endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 #endif
 }
 
@@ -159,6 +207,66 @@ void *Xcp_Thread(void *param) {
     return NULL;
 }
 
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+/*
+** DAQ worker: samples the event channels switched to asynchronous sampling.
+** Sleeps until XcpDaq_TriggerEvent() records an occurrence. Not cancelled, because it may be
+** half-way through a DTO; runs out cooperatively instead.
+*/
+void *XcpDaq_Thread(void *param) {
+    XCP_UNREFERENCED_PARAMETER(param);
+    XCP_FOREVER {
+        if (XcpThrd_IsShuttingDown()) {
+            break;
+        }
+        if (XcpDaq_ProcessEvents()) {
+            continue;
+        }
+        XcpThrd_DaqIdleSet();
+        /* Occurrences recorded before the announcement didn't signal. */
+        if (XcpDaq_ProcessEvents() || XcpThrd_IsShuttingDown()) {
+            (void)XcpThrd_DaqIdleClaim();
+            continue;
+        }
+        XcpThrd_WaitForDaqEvents();
+    }
+    return NULL;
+}
+
+/* Worker callout of the DAQ processor, runs in event context. */
+static void XcpThrd_WakeDaqWorker(void) {
+    if (XcpThrd_DaqIdlePeek() && XcpThrd_DaqIdleClaim()) {
+        XcpThrd_SignalDaqWorker();
+    }
+}
+
+static void XcpThrd_SignalDaqWorker(void) {
+    #if defined(_WIN32)
+    if (!SetEvent(XcpThrd_DaqWakeup)) {
+        XcpHw_ErrorMsg("SetEvent()", GetLastError());
+    }
+    #else
+    pthread_mutex_lock(&XcpThrd_DaqMutex);
+    XcpThrd_DaqSignaled = true;
+    pthread_cond_signal(&XcpThrd_DaqWakeup);
+    pthread_mutex_unlock(&XcpThrd_DaqMutex);
+    #endif /* _WIN32 */
+}
+
+static void XcpThrd_WaitForDaqEvents(void) {
+    #if defined(_WIN32)
+    WaitForSingleObject(XcpThrd_DaqWakeup, INFINITE);
+    #else
+    pthread_mutex_lock(&XcpThrd_DaqMutex);
+    while (!XcpThrd_DaqSignaled) {
+        pthread_cond_wait(&XcpThrd_DaqWakeup, &XcpThrd_DaqMutex);
+    }
+    XcpThrd_DaqSignaled = false;
+    pthread_mutex_unlock(&XcpThrd_DaqMutex);
+    #endif /* _WIN32 */
+}
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
 void XcpThrd_EnableAsyncCancellation(void) {
 #if defined(_WIN32)
 /* Keine direkte Entsprechung unter Windows, ggf. SetThreadPriority/Waitable-Mechanik verwenden. */
@@ -184,6 +292,9 @@ void XcpThrd_ShutDown(void) {
         return;
     }
     XcpThrd_ShuttingDown = true;
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    XcpThrd_SignalDaqWorker();
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 
 /* TL-Thread aus Blockaden holen */
 #if defined(_WIN32)
@@ -192,13 +303,18 @@ void XcpThrd_ShutDown(void) {
     if (!res) {
         XcpHw_ErrorMsg("TerminateThread", GetLastError());
     }
-/* XCP-Thread läuft kooperativ aus (Flag oben gesetzt). */
+/* XCP- und DAQ-Thread laufen kooperativ aus (Flag oben gesetzt). */
 #else
+    #if (XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET) && defined(__linux__)
+    /* Event loop of the TL thread returns by itself, once woken up. */
+    XcpTl_Wakeup();
+    #else
     /* POSIX: asynchron canceln, anschließend joinen in RunThreads. */
     res = pthread_cancel(threads[TL_THREAD]);
     if (res != 0) {
         XcpHw_ErrorMsg("pthread_cancel(TL_THREAD)", errno);
     }
+    #endif /* (XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET) && defined(__linux__) */
     res = pthread_cancel(threads[XCP_THREAD]);
     if (res != 0) {
         XcpHw_ErrorMsg("pthread_cancel(XCP_THREAD)", errno);
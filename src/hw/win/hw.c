@@ -155,13 +155,17 @@ uint32_t XcpHw_GetTimerCounter(void) {
     return (uint32_t)Now & TIMER_MASK_1;
 #elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_2
     return (uint32_t)Now & TIMER_MASK_2;
-#elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4
+#elif (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_4) || (XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_8)
     return (uint32_t)Now & TIMER_MASK_4;
 #else
     #error Timestamp-size not supported.
 #endif  // XCP_DAQ_TIMESTAMP_SIZE
 }
 
+uint64_t XcpHw_GetTimerCounter64(void) {
+    return XcpHw_GetElapsedTime(XCP_HW_TIMER_PRESCALER);
+}
+
 uint32_t XcpHw_GetTimerCounterMS(void) {
     return (uint32_t)((XcpHw_GetElapsedTime(TIMER_PS_1MS)) & TIMER_MASK_4);
 }
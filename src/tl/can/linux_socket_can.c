@@ -214,7 +214,7 @@ void XcpTl_RxHandler(void) {
             XcpHw_ErrorMsg("XcpTl_RxHandler: DLC > 8 not supported", EPROTO);
             continue;
         }
-        if (frame.can_dlc > XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE) {
+        if (frame.can_dlc > XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE) {
             XcpHw_ErrorMsg("XcpTl_RxHandler: DLC exceeds TL buffer", EOVERFLOW);
             continue;
         }
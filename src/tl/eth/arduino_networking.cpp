@@ -892,6 +892,29 @@ extern "C" {
         XCP_TL_LEAVE_CRITICAL();
     }
 
+    #if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+        #if defined(XCP_ETH_PACKET_SIZE) && (XCP_ETH_PACKET_SIZE > 0)
+            #error XCP_ETH_PACKET_SIZE is not supported on Arduino
+        #endif /* XCP_ETH_PACKET_SIZE */
+
+    /* No vectored I/O here: the frames of a batch are written one after another. */
+    void XcpTl_SendBatch(XcpTl_FrameType const * frames, uint16_t count) {
+        uint16_t idx = 0;
+
+        XCP_TL_ENTER_CRITICAL();
+        if (s_connected && s_client) {
+            for (idx = 0; idx < count; ++idx) {
+                (void)s_client->write_bytes(frames[idx].data, frames[idx].len);
+            }
+        }
+        XCP_TL_LEAVE_CRITICAL();
+    }
+
+    void XcpTl_SendPending(void) {
+        /* Nothing is held back. */
+    }
+    #endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
     void XcpTl_SaveConnection(void) {
         /* Not using address structs on Arduino; mark connected state. */
         s_connected = true;
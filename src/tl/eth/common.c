@@ -51,10 +51,15 @@ bool XcpThrd_IsShuttingDown(void);
 
 void XcpTl_PrintBtDetails(void);
 
+#if !defined(__linux__)
 static void XcpTl_Accept(void);
-static int  XcpTl_ReadHeader(uint16_t *len, uint16_t *counter);
-static int  XcpTl_ReadData(uint8_t *data, uint16_t len);
+#endif /* __linux__ */
 static int  XcpTl_ReceiveFrom(void);
+static int  XcpTl_ReceiveStream(void);
+static bool XcpTl_CheckDlc(uint16_t dlc);
+static int  XcpTl_RxRingFill(void);
+static void XcpTl_RxRingGet(uint8_t *dest, uint16_t len);
+static void XcpTl_RxRingPeekHeader(uint16_t *len, uint16_t *counter);
 
 #if XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET
 static char *Curl_inet_ntop(int af, const void *src, char *buf, size_t size);
@@ -64,6 +69,58 @@ XcpTl_ConnectionType XcpTl_Connection;
 
 static uint8_t XcpTl_RxBuffer[XCP_COMM_BUFLEN];
 
+/*
+ * TCP receive ring: holds a complete message of max. size plus the beginning of the next one, so a single
+ * recv() of up to XCP_COMM_BUFLEN bytes always fits.
+ */
+#define XCP_TL_RX_RING_SIZE (2u * XCP_COMM_BUFLEN)
+
+static uint8_t  XcpTl_RxRing[XCP_TL_RX_RING_SIZE];
+static uint16_t XcpTl_RxRingHead  = 0; /* Oldest unparsed octet. */
+static uint16_t XcpTl_RxRingCount = 0; /* Octets buffered. */
+
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE <= 1) && (XCP_ETH_PACKET_SIZE > 0)
+    #error XCP_ETH_PACKET_SIZE requires XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+#endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE <= 1) && (XCP_ETH_PACKET_SIZE > 0) */
+
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    #if XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_OFF
+        #error XCP_ETH_PACKET_SIZE requires XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION
+    #endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+    #if XCP_ETH_PACKET_SIZE < (XCP_MAX_DTO + XCP_ETH_HEADER_SIZE)
+        #error XCP_ETH_PACKET_SIZE must hold at least one DTO
+    #endif /* XCP_ETH_PACKET_SIZE */
+
+    /* XCP_ETH_FLUSH_TIME in units of XcpHw_GetTimerCounter64(). */
+    #if XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1NS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME * 1000ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10NS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME * 100ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100NS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME * 10ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1US
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10US
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 10ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100US
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 100ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1MS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 1000ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_10MS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 10000ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_100MS
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 100000ULL)
+    #elif XCP_DAQ_TIMESTAMP_UNIT == XCP_DAQ_TIMESTAMP_UNIT_1S
+        #define XCP_ETH_FLUSH_TICKS ((uint64_t)XCP_ETH_FLUSH_TIME / 1000000ULL)
+    #else
+        #error Timestamp-unit not supported.
+    #endif /* XCP_DAQ_TIMESTAMP_UNIT */
+
+static uint8_t  XcpTl_PackBuffer[XCP_ETH_PACKET_SIZE];
+static uint16_t XcpTl_PackLen       = 0;
+static uint64_t XcpTl_PackStartedAt = 0;
+#endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+
 static bool XcpTl_ParseIpv4(const char *ip, struct in_addr *out) {
 #if defined(_WIN32)
     return InetPtonA(AF_INET, ip, out) == 1;
@@ -370,6 +427,8 @@ bool XcpTl_HandleTransportMulticastPacket(const uint8_t *buf, size_t n) {
     return false;
 }
 
+#if !defined(__linux__)
+/* Blocking receiver; Linux uses an epoll driven event loop instead (linuxeth.c). */
 void *XcpTl_Thread(void *param) {
     XCP_UNREFERENCED_PARAMETER(param);
     XcpThrd_EnableAsyncCancellation();
@@ -383,6 +442,7 @@ void XcpTl_MainFunction(void) {
     XcpTl_Accept();
     XcpTl_RxHandler();
 }
+#endif /* __linux__ */
 
 void *get_in_addr(struct sockaddr *sa) {
     if (sa->sa_family == AF_INET) {
@@ -391,69 +451,10 @@ void *get_in_addr(struct sockaddr *sa) {
     return &(((struct sockaddr_in6 *)sa)->sin6_addr);
 }
 
-static int XcpTl_ReadHeader(uint16_t *len, uint16_t *counter) {
-    uint8_t   header_buffer[8];
-    uint8_t   bytes_remaining = XCP_ETH_HEADER_SIZE;
-    uint8_t   offset          = 0;
-    int       nbytes          = 0;
-    socklen_t from_len        = (socklen_t)sizeof(XcpTl_Connection.currentAddress);
-
-    XCP_FOREVER {
-        if (XcpTl_Connection.socketType == SOCK_DGRAM) {
-            /* For UDP, the header is already in the buffer. */
-            XcpUtl_MemCopy(header_buffer, XcpTl_RxBuffer, XCP_ETH_HEADER_SIZE);
-            nbytes = XCP_ETH_HEADER_SIZE;
-        } else if (XcpTl_Connection.socketType == SOCK_STREAM) {
-            nbytes = recv(XcpTl_Connection.connectedSocket, (char *)header_buffer + offset, bytes_remaining, 0);
-            if (XcpThrd_IsShuttingDown()) {
-                return 0;
-            }
-        }
-        if (nbytes <= 0) {
-            return nbytes;
-        }
-        bytes_remaining -= (uint8_t)nbytes;
-        if (bytes_remaining == 0) {
-            break;
-        }
-        offset = (uint8_t)(offset + nbytes);
-    }
-
-    *len     = XCP_MAKEWORD(header_buffer[1], header_buffer[0]);
-    *counter = XCP_MAKEWORD(header_buffer[3], header_buffer[2]);
-    return 1;
-}
-
-static int XcpTl_ReadData(uint8_t *data, uint16_t len) {
-    uint16_t  bytes_remaining = len;
-    uint16_t  offset          = 0;
-    int       nbytes          = 0;
-    socklen_t from_len        = (socklen_t)sizeof(XcpTl_Connection.currentAddress);
-
-    XCP_FOREVER {
-        if (XcpTl_Connection.socketType == SOCK_DGRAM) {
-            /* For UDP, the data is already in the buffer. */
-            XcpUtl_MemCopy(data, XcpTl_RxBuffer + XCP_ETH_HEADER_SIZE, len);
-            nbytes = len;
-        } else if (XcpTl_Connection.socketType == SOCK_STREAM) {
-            nbytes = recv(XcpTl_Connection.connectedSocket, (char *)data + offset, bytes_remaining, 0);
-        }
-        if (nbytes <= 0) {
-            return nbytes;
-        }
-        bytes_remaining = (uint16_t)(bytes_remaining - (uint16_t)nbytes);
-        if (bytes_remaining == 0) {
-            break;
-        }
-        offset = (uint16_t)(offset + (uint16_t)nbytes);
-    }
-    return 1;
-}
-
 static int XcpTl_ReceiveFrom(void) {
     socklen_t from_len = (socklen_t)sizeof(XcpTl_Connection.currentAddress);
     int       nbytes   = recvfrom(
-        XcpTl_Connection.boundSocket, (char *)XcpTl_RxBuffer, (int)XCP_COMM_BUFLEN, 0,
+        XcpTl_Connection.boundSocket, (char *)XcpTl_RxBuffer, (int)XCP_COMM_BUFLEN, XCP_ETH_RECV_FLAGS,
         (struct sockaddr *)&XcpTl_Connection.currentAddress, &from_len
     );
     if (XcpThrd_IsShuttingDown()) {
@@ -463,74 +464,168 @@ static int XcpTl_ReceiveFrom(void) {
 }
 
 void XcpTl_RxHandler(void) {
+    /* Avoid unnecessary buffer clearing; we read directly into destination. */
+    while (XcpTl_ReceiveMessage() > 0) {
+    }
+}
+
+/*
+ * Receives and dispatches commands. Returns 1 if something was received (call again), 0 if there is nothing
+ * to receive right now (or we're shutting down) and -1 if the connection is gone, i.e. has been released.
+ */
+int XcpTl_ReceiveMessage(void) {
+    int      res;
+    uint16_t dlc = 0U;
+
+    if (XcpTl_Connection.socketType == SOCK_STREAM) {
+        return XcpTl_ReceiveStream();
+    }
+
+    /* UDP: one datagram, one command. */
+    res = XcpTl_ReceiveFrom();
+#if defined(__linux__)
+    if ((res == -1) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+        return 0;
+    }
+#endif /* __linux__ */
+    if (XcpThrd_IsShuttingDown()) {
+        return 0;
+    }
+    if (res <= 0) {
+        XcpTl_ReleaseConnection();
+        return -1;
+    }
+    /* The header is followed by the payload in the datagram, the counter is of no interest. */
+    if (res < XCP_ETH_HEADER_SIZE) {
+        return 1; /* Truncated, dropped. */
+    }
+    dlc = XCP_MAKEWORD(XcpTl_RxBuffer[1], XcpTl_RxBuffer[0]);
+    if (!XcpTl_CheckDlc(dlc)) {
+        return -1;
+    }
+    if (res < (XCP_ETH_HEADER_SIZE + (int)dlc)) {
+        return 1; /* Payload shorter than announced, dropped. */
+    }
+
+    /* For UDP: learn peer address on first packet so replies go back via sendto(). */
+    if (!XcpTl_Connection.connected) {
+        XcpTl_SaveConnection();
+    }
+
+    Xcp_CtoIn.len = dlc;
+    XcpUtl_MemCopy(Xcp_CtoIn.data, XcpTl_RxBuffer + XCP_ETH_HEADER_SIZE, dlc);
+    XCP_ASSERT_LE(dlc, XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE);
+    Xcp_DispatchCommand(&Xcp_CtoIn);
+    return 1;
+}
+
+/*
+ * TCP: a single recv() takes whatever the socket has (up to XCP_COMM_BUFLEN octets) into the receive ring,
+ * complete messages are then dispatched from memory, so pipelined commands (block-mode DOWNLOAD_NEXT, command
+ * queues of the master) don't cost a syscall each. A partially received message waits in the ring.
+ */
+static int XcpTl_ReceiveStream(void) {
     int      res;
     uint16_t dlc     = 0U;
     uint16_t counter = 0U;
 
-    /* Avoid unnecessary buffer clearing; we read directly into destination. */
-
-    XCP_FOREVER {
-        if (XcpTl_Connection.socketType == SOCK_DGRAM) {
-            res = XcpTl_ReceiveFrom();
-            if (res <= 0) {
-                XcpTl_ReleaseConnection();
-                return;
+    if (XcpTl_RxRingCount >= XCP_ETH_HEADER_SIZE) {
+        XcpTl_RxRingPeekHeader(&dlc, &counter);
+        if (!XcpTl_CheckDlc(dlc)) {
+            XcpTl_RxRingCount = 0;
+            return -1;
+        }
+        if (XcpTl_RxRingCount >= (XCP_ETH_HEADER_SIZE + dlc)) {
+            XcpTl_RxRingGet(XCP_NULL, XCP_ETH_HEADER_SIZE);
+            XcpTl_RxRingGet(Xcp_CtoIn.data, dlc);
+            Xcp_CtoIn.len = dlc;
+            if (XcpThrd_IsShuttingDown()) {
+                return 0;
             }
+            XCP_ASSERT_LE(dlc, XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE);
+            Xcp_DispatchCommand(&Xcp_CtoIn);
+            return 1;
         }
+    }
 
-        res = XcpTl_ReadHeader(&dlc, &counter);
-        if (res == -1) {
+    res = XcpTl_RxRingFill();
+    if (XcpThrd_IsShuttingDown()) {
+        return 0;
+    }
+    if (res == -1) {
 #if defined(_WIN32)
-            XcpHw_ErrorMsg("XcpTl_RxHandler:XcpTl_ReadHeader()", WSAGetLastError());
+        XcpHw_ErrorMsg("XcpTl_RxHandler:recv()", WSAGetLastError());
 #elif defined(__unix__) || defined(__APPLE__)
-            XcpHw_ErrorMsg("XcpTl_RxHandler:XcpTl_ReadHeader()", errno);
-#endif
-            XcpTl_ReleaseConnection();
-            return;
-        } else if (res == 0) {
-            XcpTl_ReleaseConnection();
-            return;
+        if (errno == EINTR) {
+            return 1;
         }
-
-        /* DLC-Sanity-Check. */
-        if (dlc > XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE || dlc > (uint16_t)XCP_COMM_BUFLEN) {
-            XcpHw_ErrorMsg("XcpTl_RxHandler: DLC too large", EINVAL);
-            XcpTl_ReleaseConnection();
-            return;
+    #if defined(__linux__)
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return 0;
         }
+    #endif /* __linux__ */
+        XcpHw_ErrorMsg("XcpTl_RxHandler:recv()", errno);
+#endif
+    }
+    if (res <= 0) {
+        /* Connection closed. */
+        XcpTl_RxRingCount = 0;
+        XcpTl_ReleaseConnection();
+        return -1;
+    }
+    return 1;
+}
 
-        /* For UDP: learn peer address on first packet so replies go back via sendto(). */
-        if ((XcpTl_Connection.socketType == SOCK_DGRAM) && (!XcpTl_Connection.connected)) {
-            XcpTl_SaveConnection();
-        }
+static bool XcpTl_CheckDlc(uint16_t dlc) {
+    /* DLC-Sanity-Check. */
+    if (dlc > XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE || dlc > (uint16_t)XCP_COMM_BUFLEN) {
+        XcpHw_ErrorMsg("XcpTl_RxHandler: DLC too large", EINVAL);
+        XcpTl_ReleaseConnection();
+        return false;
+    }
+    return true;
+}
 
-        if (!XcpThrd_IsShuttingDown()) {
-            Xcp_CtoIn.len = dlc;
-            /* Read payload directly into target buffer to avoid an extra copy. */
-            res = XcpTl_ReadData(Xcp_CtoIn.data, dlc);
-            if (res == -1) {
-#if defined(_WIN32)
-                XcpHw_ErrorMsg("XcpTl_RxHandler:XcpTl_ReadData()", WSAGetLastError());
-#elif defined(__unix__) || defined(__APPLE__)
-                XcpHw_ErrorMsg("XcpTl_RxHandler:XcpTl_ReadData()", errno);
-#endif
-                XcpTl_ReleaseConnection();
-                return;
-            } else if (res == 0) {
-                /* Connection closed /no data. */
-                XcpTl_ReleaseConnection();
-                return;
-            }
-            XCP_ASSERT_LE(dlc, XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE);
-            // XcpUtl_MemCopy(Xcp_CtoIn.data, XcpTl_RxBuffer, dlc);
-            Xcp_DispatchCommand(&Xcp_CtoIn);
-        } else {
-            /* Shutting down */
-            return;
-        }
+/*
+ * Receives into the free space behind the buffered octets; if that wraps, the rest is taken by the next call.
+ */
+static int XcpTl_RxRingFill(void) {
+    uint16_t tail = (uint16_t)((XcpTl_RxRingHead + XcpTl_RxRingCount) % XCP_TL_RX_RING_SIZE);
+    uint16_t len  = (uint16_t)XCP_MIN(XCP_TL_RX_RING_SIZE - XcpTl_RxRingCount, XCP_COMM_BUFLEN);
+    int      nbytes;
+
+    len    = (uint16_t)XCP_MIN(len, XCP_TL_RX_RING_SIZE - tail);
+    nbytes = recv(XcpTl_Connection.connectedSocket, (char *)&XcpTl_RxRing[tail], len, XCP_ETH_RECV_FLAGS);
+    if (nbytes > 0) {
+        XcpTl_RxRingCount = (uint16_t)(XcpTl_RxRingCount + (uint16_t)nbytes);
+    }
+    return nbytes;
+}
+
+/* Takes `len` octets out of the ring, `dest` may be XCP_NULL to skip them. */
+static void XcpTl_RxRingGet(uint8_t *dest, uint16_t len) {
+    uint16_t first = (uint16_t)XCP_MIN(len, XCP_TL_RX_RING_SIZE - XcpTl_RxRingHead);
+
+    if (dest != XCP_NULL) {
+        XcpUtl_MemCopy(dest, &XcpTl_RxRing[XcpTl_RxRingHead], first);
+        XcpUtl_MemCopy(dest + first, &XcpTl_RxRing[0], (uint32_t)(len - first));
     }
+    XcpTl_RxRingHead  = (uint16_t)((XcpTl_RxRingHead + len) % XCP_TL_RX_RING_SIZE);
+    XcpTl_RxRingCount = (uint16_t)(XcpTl_RxRingCount - len);
 }
 
+static void XcpTl_RxRingPeekHeader(uint16_t *len, uint16_t *counter) {
+    uint8_t  header[XCP_ETH_HEADER_SIZE];
+    uint16_t idx = 0;
+
+    for (idx = 0; idx < XCP_ETH_HEADER_SIZE; ++idx) {
+        header[idx] = XcpTl_RxRing[(XcpTl_RxRingHead + idx) % XCP_TL_RX_RING_SIZE];
+    }
+    *len     = XCP_MAKEWORD(header[1], header[0]);
+    *counter = XCP_MAKEWORD(header[3], header[2]);
+}
+
+#if !defined(__linux__)
 static void XcpTl_Accept(void) {
     socklen_t               FromLen = 0;
     struct sockaddr_storage From;
@@ -559,10 +654,64 @@ static void XcpTl_Accept(void) {
         }
     }
 }
+#endif /* __linux__ */
 
 void XcpTl_TxHandler(void) {
 }
 
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+    #if XCP_ETH_PACKET_SIZE > 0
+/*
+ * DTO packing: frames of XcpTl_SendBatch() are collected into one UDP datagram / TCP write, which is sent
+ * as soon as the next frame doesn't fit, before any other message (XcpTl_Send()), or XCP_ETH_FLUSH_TIME us
+ * after its first frame. The caller holds the TL lock.
+ */
+void XcpTl_PackFrames(XcpTl_FrameType const *frames, uint16_t count) {
+    uint16_t idx     = 0;
+    bool     started = false;
+
+    for (idx = 0; idx < count; ++idx) {
+        if ((XcpTl_PackLen + frames[idx].len) > XCP_ETH_PACKET_SIZE) {
+            XcpTl_FlushPacked(true);
+        }
+        if (XcpTl_PackLen == 0) {
+            /* New packet, possibly after a full one was sent above: its deadline replaces the previous one. */
+            XcpTl_PackStartedAt = XcpHw_GetTimerCounter64();
+            started             = true;
+        }
+        XcpUtl_MemCopy(&XcpTl_PackBuffer[XcpTl_PackLen], frames[idx].data, frames[idx].len);
+        XcpTl_PackLen += frames[idx].len;
+    }
+    XcpTl_FlushPacked(false);
+        #if defined(__linux__)
+    if (started && (XcpTl_PackLen > 0)) {
+        /* The event loop flushes when the timer expires. */
+        XcpTl_ArmFlushTimer();
+    }
+        #endif /* __linux__ */
+}
+
+void XcpTl_FlushPacked(bool force) {
+    if (XcpTl_PackLen == 0) {
+        return;
+    }
+    if (!force && ((XcpHw_GetTimerCounter64() - XcpTl_PackStartedAt) < XCP_ETH_FLUSH_TICKS)) {
+        return;
+    }
+    XcpTl_Transmit(XcpTl_PackBuffer, XcpTl_PackLen);
+    XcpTl_PackLen = 0;
+}
+    #endif /* XCP_ETH_PACKET_SIZE */
+
+void XcpTl_SendPending(void) {
+    #if XCP_ETH_PACKET_SIZE > 0
+    XCP_TL_ENTER_CRITICAL();
+    XcpTl_FlushPacked(false);
+    XCP_TL_LEAVE_CRITICAL();
+    #endif /* XCP_ETH_PACKET_SIZE */
+}
+#endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
 void XcpTl_SaveConnection(void) {
     XcpUtl_MemCopy(&XcpTl_Connection.connectionAddress, &XcpTl_Connection.currentAddress, sizeof(struct sockaddr_storage));
     XcpTl_Connection.connected = XCP_TRUE;
@@ -570,6 +719,12 @@ void XcpTl_SaveConnection(void) {
 
 void XcpTl_ReleaseConnection(void) {
     XcpTl_Connection.connected = XCP_FALSE;
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    /* DTOs packed for the previous master are dropped. */
+    XCP_TL_ENTER_CRITICAL();
+    XcpTl_PackLen = 0;
+    XCP_TL_LEAVE_CRITICAL();
+#endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
 }
 
 bool XcpTl_VerifyConnection(void) {
@@ -29,15 +29,48 @@
 #include "xcp.h"
 #include "xcp_eth.h"
 #include "xcp_hw.h"
+#include "xcp_threads.h"
 /*!!! END-INCLUDE-SECTION !!!*/
 
 #include <pthread.h>
+#include <sys/uio.h>
 
 #if defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON)
     #include "xcp_timecorr.h"
 #endif /* XCP_ENABLE_TIME_CORRELATION */
 
+static bool XcpTl_StreamWrite(struct iovec *iov, int iovcnt);
+static void XcpTl_DropConnection(void);
+
+#if defined(__linux__)
+static void XcpTl_InitEventLoop(void);
+static void XcpTl_HandleEvent(int fd);
+static void XcpTl_AcceptConnection(void);
+static void XcpTl_CloseConnection(void);
+static void XcpTl_Watch(int fd);
+static void XcpTl_Unwatch(int fd);
+#else
 static void *XcpTl_MulticastThread(void *param);
+#endif /* __linux__ */
+
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE == 0)
+static void XcpTl_SendSegments(XcpTl_FrameType const *frames, uint16_t count);
+    #if defined(__linux__)
+static void XcpTl_SendDatagrams(XcpTl_FrameType const *frames, uint16_t count);
+    #endif /* __linux__ */
+#endif     /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE == 0) */
+
+/* A vanished master shall not kill us with SIGPIPE. */
+#if defined(MSG_NOSIGNAL)
+    #define XCP_TL_SEND_FLAGS MSG_NOSIGNAL
+#else
+    #define XCP_TL_SEND_FLAGS 0
+#endif /* MSG_NOSIGNAL */
+
+#if defined(__linux__)
+    /* Bound, connected, discovery and multicast socket plus the eventfd and the timerfd. */
+    #define XCP_TL_POLL_EVENTS (6)
+#endif /* __linux__ */
 
 socklen_t addrSize = sizeof(struct sockaddr_storage);
 
@@ -88,6 +121,10 @@ void XcpTl_Init(void) {
     int              ret  = 0;
 
     XcpUtl_ZeroMem(&XcpTl_Connection, sizeof(XcpTl_ConnectionType));
+    XcpTl_Connection.connectedSocket = INVALID_SOCKET;
+    XcpTl_Connection.pollFd          = -1;
+    XcpTl_Connection.eventFd         = -1;
+    XcpTl_Connection.timerFd         = -1;
     memset(&hints, 0, sizeof(hints));
     XcpTl_Connection.socketType = Xcp_Options.tcp ? SOCK_STREAM : SOCK_DGRAM;
     (void)snprintf(port, sizeof(port), "%d", Xcp_Options.port);
@@ -226,16 +263,38 @@ void XcpTl_Init(void) {
     }
 #endif /* XCP_ENABLE_TIME_CORRELATION */
 
+#if defined(__linux__)
+    XcpTl_InitEventLoop();
+#else
     if ((XcpTl_Connection.discoverySocket >= 0) || (XcpTl_Connection.multicastSocket >= 0)) {
-#if (XCP_ENABLE_ETH_DISCOVERY == XCP_ON) || (defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON))
+    #if (XCP_ENABLE_ETH_DISCOVERY == XCP_ON) || (defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON))
         pthread_t mcast_thread;
         pthread_create(&mcast_thread, NULL, XcpTl_MulticastThread, NULL);
         pthread_detach(mcast_thread);
-#endif
+    #endif
     }
+#endif /* __linux__ */
 }
 
 void XcpTl_DeInit(void) {
+#if defined(__linux__)
+    if (XcpTl_Connection.eventFd >= 0) {
+        close(XcpTl_Connection.eventFd);
+        XcpTl_Connection.eventFd = -1;
+    }
+    if (XcpTl_Connection.timerFd >= 0) {
+        close(XcpTl_Connection.timerFd);
+        XcpTl_Connection.timerFd = -1;
+    }
+    if (XcpTl_Connection.pollFd >= 0) {
+        close(XcpTl_Connection.pollFd);
+        XcpTl_Connection.pollFd = -1;
+    }
+#endif /* __linux__ */
+    if (XcpTl_Connection.connectedSocket >= 0) {
+        close(XcpTl_Connection.connectedSocket);
+        XcpTl_Connection.connectedSocket = INVALID_SOCKET;
+    }
     if (XcpTl_Connection.multicastSocket >= 0) {
         close(XcpTl_Connection.multicastSocket);
         XcpTl_Connection.multicastSocket = -1;
@@ -253,6 +312,18 @@ void XcpTl_DeInit(void) {
 void XcpTl_Send(uint8_t const *buf, uint16_t len) {
     // XcpUtl_Hexdump(buf,  len);
     XCP_TL_ENTER_CRITICAL();
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    /* Packed DTOs go first, the transport layer counter has to be consecutive. */
+    XcpTl_FlushPacked(true);
+#endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+    XcpTl_Transmit(buf, len);
+    XCP_TL_LEAVE_CRITICAL();
+}
+
+/*
+ * Sends a message (or several packed ones) as is, the caller holds the TL lock.
+ */
+void XcpTl_Transmit(uint8_t const *buf, uint16_t len) {
     if (XcpTl_Connection.socketType == SOCK_DGRAM) {
         if (sendto(
                 XcpTl_Connection.boundSocket, (char const *)buf, len, 0,
@@ -261,15 +332,351 @@ void XcpTl_Send(uint8_t const *buf, uint16_t len) {
             XcpHw_ErrorMsg("XcpTl_Send:sendto()", errno);
         }
     } else if (XcpTl_Connection.socketType == SOCK_STREAM) {
-        if (send(XcpTl_Connection.connectedSocket, (char const *)buf, len, 0) == -1) {
-            XcpHw_ErrorMsg("XcpTl_Send:send()", errno);
-            close(XcpTl_Connection.connectedSocket);
+        struct iovec iov;
+
+        iov.iov_base = (void *)buf;
+        iov.iov_len  = len;
+        if (!XcpTl_StreamWrite(&iov, 1)) {
+            XcpHw_ErrorMsg("XcpTl_Send:sendmsg()", errno);
+            XcpTl_DropConnection();
+        }
+    }
+}
+
+/*
+ * Writes an I/O vector completely to the TCP connection, a stream socket may accept less than requested.
+ * `iov` is consumed (advanced past the written data). The caller holds the TL lock.
+ */
+static bool XcpTl_StreamWrite(struct iovec *iov, int iovcnt) {
+    struct msghdr msg;
+    ssize_t       written = 0;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = iovcnt;
+    while (msg.msg_iovlen > 0) {
+        written = sendmsg(XcpTl_Connection.connectedSocket, &msg, XCP_TL_SEND_FLAGS);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        /* Skip the completely written elements, resume within a partially written one. */
+        while ((msg.msg_iovlen > 0) && ((size_t)written >= msg.msg_iov->iov_len)) {
+            written -= (ssize_t)msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (uint8_t *)msg.msg_iov->iov_base + written;
+            msg.msg_iov->iov_len -= (size_t)written;
+        }
+    }
+    return true;
+}
+
+/*
+ * Gives up the TCP connection after a failed write. On Linux the event loop sees the EOF, closes the socket
+ * and accepts the next master; the descriptor must not be reused behind its back.
+ */
+static void XcpTl_DropConnection(void) {
+#if defined(__linux__)
+    shutdown(XcpTl_Connection.connectedSocket, SHUT_RDWR);
+#else
+    close(XcpTl_Connection.connectedSocket);
+#endif /* __linux__ */
+}
+
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+/*
+ * Sends a batch of frames in order: packed (XCP_ETH_PACKET_SIZE), with a single vectored write (TCP)
+ * or, on Linux, all datagrams with a single sendmmsg() call.
+ */
+void XcpTl_SendBatch(XcpTl_FrameType const *frames, uint16_t count) {
+    #if XCP_ETH_PACKET_SIZE > 0
+    XCP_TL_ENTER_CRITICAL();
+    XcpTl_PackFrames(frames, count);
+    XCP_TL_LEAVE_CRITICAL();
+    #else
+        #if !defined(__linux__)
+    uint16_t idx = 0;
+        #endif /* __linux__ */
+
+    if (XcpTl_Connection.socketType == SOCK_STREAM) {
+        XcpTl_SendSegments(frames, count);
+        return;
+    }
+        #if defined(__linux__)
+    XcpTl_SendDatagrams(frames, count);
+        #else
+    for (idx = 0; idx < count; ++idx) {
+        XcpTl_Send(frames[idx].data, frames[idx].len);
+    }
+        #endif /* __linux__ */
+    #endif     /* XCP_ETH_PACKET_SIZE */
+}
+
+    #if XCP_ETH_PACKET_SIZE == 0
+/*
+ * TCP: frames are written straight from the DTO queue slots (header included) with one sendmsg(),
+ * as long as the socket takes them.
+ */
+static void XcpTl_SendSegments(XcpTl_FrameType const *frames, uint16_t count) {
+    struct iovec iovs[XCP_DAQ_TRANSMIT_BATCH_SIZE];
+    uint16_t     idx = 0;
+
+    for (idx = 0; idx < count; ++idx) {
+        iovs[idx].iov_base = (void *)frames[idx].data;
+        iovs[idx].iov_len  = frames[idx].len;
+    }
+    XCP_TL_ENTER_CRITICAL();
+    if (!XcpTl_StreamWrite(iovs, (int)count)) {
+        XcpHw_ErrorMsg("XcpTl_SendBatch:sendmsg()", errno);
+        XcpTl_DropConnection();
+    }
+    XCP_TL_LEAVE_CRITICAL();
+}
+    #endif /* XCP_ETH_PACKET_SIZE */
+
+    #if (XCP_ETH_PACKET_SIZE == 0) && defined(__linux__)
+static void XcpTl_SendDatagrams(XcpTl_FrameType const *frames, uint16_t count) {
+    struct mmsghdr msgs[XCP_DAQ_TRANSMIT_BATCH_SIZE];
+    struct iovec   iovs[XCP_DAQ_TRANSMIT_BATCH_SIZE];
+    uint16_t       idx  = 0;
+    int            sent = 0;
+
+    memset(msgs, 0, count * sizeof(struct mmsghdr));
+    for (idx = 0; idx < count; ++idx) {
+        iovs[idx].iov_base            = (void *)frames[idx].data;
+        iovs[idx].iov_len             = frames[idx].len;
+        msgs[idx].msg_hdr.msg_name    = (void *)&XcpTl_Connection.connectionAddress;
+        msgs[idx].msg_hdr.msg_namelen = addrSize;
+        msgs[idx].msg_hdr.msg_iov     = &iovs[idx];
+        msgs[idx].msg_hdr.msg_iovlen  = 1;
+    }
+    XCP_TL_ENTER_CRITICAL();
+    idx = 0;
+    while (idx < count) {
+        sent = sendmmsg(XcpTl_Connection.boundSocket, &msgs[idx], count - idx, 0);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            XcpHw_ErrorMsg("XcpTl_SendBatch:sendmmsg()", errno);
+            break;
+        }
+        idx += (uint16_t)sent;
+    }
+    XCP_TL_LEAVE_CRITICAL();
+}
+    #endif /* (XCP_ETH_PACKET_SIZE == 0) && defined(__linux__) */
+#endif     /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
+#if defined(__linux__)
+
+/*
+ * Event loop of the TL thread: a single epoll set watches the bound socket (listening resp. UDP), the connected
+ * TCP socket, the discovery and time-correlation multicast sockets, an eventfd, which wakes the loop up on
+ * shutdown, and a timerfd for the flush deadline of packed DTOs.
+ */
+void *XcpTl_Thread(void *param) {
+    XCP_UNREFERENCED_PARAMETER(param);
+    if (XcpTl_Connection.pollFd == -1) {
+        /* XcpTl_Init() failed. */
+        return NULL;
+    }
+    XCP_FOREVER {
+        if (XcpThrd_IsShuttingDown()) {
+            break;
+        }
+        XcpTl_MainFunction();
+    }
+    return NULL;
+}
+
+void XcpTl_MainFunction(void) {
+    struct epoll_event events[XCP_TL_POLL_EVENTS];
+    int                ready = 0;
+    int                idx   = 0;
+
+    ready = epoll_wait(XcpTl_Connection.pollFd, events, XCP_TL_POLL_EVENTS, -1);
+    if (ready == -1) {
+        if (errno != EINTR) {
+            XcpHw_ErrorMsg("XcpTl_MainFunction:epoll_wait()", errno);
+        }
+        return;
+    }
+    for (idx = 0; idx < ready; ++idx) {
+        XcpTl_HandleEvent(events[idx].data.fd);
+    }
+}
+
+void XcpTl_Wakeup(void) {
+    if (XcpTl_Connection.eventFd != -1) {
+        (void)eventfd_write(XcpTl_Connection.eventFd, (eventfd_t)1);
+    }
+}
+
+static void XcpTl_InitEventLoop(void) {
+    int flags = 0;
+
+    XcpTl_Connection.pollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (XcpTl_Connection.pollFd == -1) {
+        XcpHw_ErrorMsg("XcpTl_Init:epoll_create1()", errno);
+        return;
+    }
+    XcpTl_Connection.eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (XcpTl_Connection.eventFd == -1) {
+        XcpHw_ErrorMsg("XcpTl_Init:eventfd()", errno);
+        close(XcpTl_Connection.pollFd);
+        XcpTl_Connection.pollFd = -1;
+        return;
+    }
+    if (XcpTl_Connection.socketType == SOCK_STREAM) {
+        /* A connection may be gone again until accept() is called. */
+        flags = fcntl(XcpTl_Connection.boundSocket, F_GETFL, 0);
+        if ((flags == -1) || (fcntl(XcpTl_Connection.boundSocket, F_SETFL, flags | O_NONBLOCK) == -1)) {
+            XcpHw_ErrorMsg("XcpTl_Init:fcntl(O_NONBLOCK)", errno);
+        }
+    }
+    XcpTl_Watch(XcpTl_Connection.eventFd);
+    #if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    XcpTl_Connection.timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (XcpTl_Connection.timerFd == -1) {
+        XcpHw_ErrorMsg("XcpTl_Init:timerfd_create()", errno);
+    } else {
+        XcpTl_Watch(XcpTl_Connection.timerFd);
+    }
+    #endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+    XcpTl_Watch(XcpTl_Connection.boundSocket);
+    if (XcpTl_Connection.discoverySocket >= 0) {
+        XcpTl_Watch(XcpTl_Connection.discoverySocket);
+    }
+    if (XcpTl_Connection.multicastSocket >= 0) {
+        XcpTl_Watch(XcpTl_Connection.multicastSocket);
+    }
+}
+
+static void XcpTl_HandleEvent(int fd) {
+    uint8_t   buf[128];
+    ssize_t   n   = 0;
+    int       res = 0;
+    eventfd_t value;
+    #if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    uint64_t expirations = 0;
+    #endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+
+    if (fd == XcpTl_Connection.eventFd) {
+        /* Shutdown is checked by the loop. */
+        (void)eventfd_read(XcpTl_Connection.eventFd, &value);
+    #if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    } else if (fd == XcpTl_Connection.timerFd) {
+        /* Nothing to read: the timer has been re-armed (for a newer packet) in the meantime. */
+        if (read(fd, &expirations, sizeof(expirations)) == (ssize_t)sizeof(expirations)) {
+            XCP_TL_ENTER_CRITICAL();
+            XcpTl_FlushPacked(true);
+            XCP_TL_LEAVE_CRITICAL();
+        }
+    #endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+    } else if (fd == XcpTl_Connection.boundSocket) {
+        if (XcpTl_Connection.socketType == SOCK_STREAM) {
+            XcpTl_AcceptConnection();
+        } else {
+            while (XcpTl_ReceiveMessage() > 0) {
+            }
+        }
+    } else if (fd == XcpTl_Connection.connectedSocket) {
+        /* Everything that has arrived, the receive ring takes it in chunks of XCP_COMM_BUFLEN. */
+        do {
+            res = XcpTl_ReceiveMessage();
+        } while (res > 0);
+        if (res == -1) {
+            XcpTl_CloseConnection();
+        }
+    } else if ((fd == XcpTl_Connection.discoverySocket) || (fd == XcpTl_Connection.multicastSocket)) {
+        /*
+         * Transport-layer multicast commands, packet layout (Intel byte order):
+         *   [0..1]  len (WORD)
+         *   [2..3]  transport counter (WORD)
+         *   [4]     0xF2  (TRANSPORT_LAYER_CMD)
+         *   [5]     sub-command (0xFA/0xFF/0xFD/0xFC)
+         *   [6..]   payload per sub-command
+         */
+        n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) {
+            XcpTl_HandleTransportMulticastPacket(buf, (size_t)n);
+        }
+    }
+}
+
+static void XcpTl_AcceptConnection(void) {
+    socklen_t from_len = (socklen_t)sizeof(XcpTl_Connection.currentAddress);
+    int       sock     = INVALID_SOCKET;
+
+    sock = accept(XcpTl_Connection.boundSocket, (struct sockaddr *)&XcpTl_Connection.currentAddress, &from_len);
+    if (sock == INVALID_SOCKET) {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) && (errno != ECONNABORTED)) {
+            XcpHw_ErrorMsg("XcpTl_Accept::accept()", errno);
         }
+        return;
     }
+    XcpTl_Connection.connectedSocket = sock;
+    XcpTl_SaveConnection();
+    /* One master at a time, further ones wait in the backlog. */
+    XcpTl_Unwatch(XcpTl_Connection.boundSocket);
+    XcpTl_Watch(sock);
+}
+
+static void XcpTl_CloseConnection(void) {
+    XCP_TL_ENTER_CRITICAL();
+    close(XcpTl_Connection.connectedSocket); /* Also removes it from the epoll set. */
+    XcpTl_Connection.connectedSocket = INVALID_SOCKET;
     XCP_TL_LEAVE_CRITICAL();
+    XcpTl_Watch(XcpTl_Connection.boundSocket);
+}
+
+static void XcpTl_Watch(int fd) {
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events  = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(XcpTl_Connection.pollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        XcpHw_ErrorMsg("XcpTl_Watch:epoll_ctl()", errno);
+    }
+}
+
+static void XcpTl_Unwatch(int fd) {
+    if (epoll_ctl(XcpTl_Connection.pollFd, EPOLL_CTL_DEL, fd, NULL) == -1) {
+        XcpHw_ErrorMsg("XcpTl_Unwatch:epoll_ctl()", errno);
+    }
+}
+
+    #if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+/*
+ * (Re-)starts the one-shot flush timer, called with the TL lock held when a new packet is started;
+ * epoll_wait() would only offer a resolution of milliseconds.
+ */
+void XcpTl_ArmFlushTimer(void) {
+    struct itimerspec deadline;
+
+    if (XcpTl_Connection.timerFd == -1) {
+        return;
+    }
+    memset(&deadline, 0, sizeof(deadline));
+    deadline.it_value.tv_sec  = (time_t)(XCP_ETH_FLUSH_TIME / 1000000u);
+    deadline.it_value.tv_nsec = (long)((XCP_ETH_FLUSH_TIME % 1000000u) * 1000u);
+    if ((deadline.it_value.tv_sec == 0) && (deadline.it_value.tv_nsec == 0)) {
+        deadline.it_value.tv_nsec = 1; /* All zero would disarm the timer. */
+    }
+    if (timerfd_settime(XcpTl_Connection.timerFd, 0, &deadline, NULL) == -1) {
+        XcpHw_ErrorMsg("XcpTl_ArmFlushTimer:timerfd_settime()", errno);
+    }
 }
+    #endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
 
-#if (XCP_ENABLE_ETH_DISCOVERY == XCP_ON) || (defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON))
+#elif (XCP_ENABLE_ETH_DISCOVERY == XCP_ON) || (defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON))
 
 /*
  * Thread that receives transport-layer multicast commands.
@@ -327,7 +734,7 @@ static void *XcpTl_MulticastThread(void *param) {
     return NULL;
 }
 
-#endif /* discovery/timecorr multicast listener */
+#endif /* __linux__, discovery/timecorr multicast listener */
 
 #if defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON)
 
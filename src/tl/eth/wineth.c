@@ -362,6 +362,18 @@ void XcpTl_MainFunction(void) {
 
 void XcpTl_Send(uint8_t const *buf, uint16_t len) {
     XCP_TL_ENTER_CRITICAL();
+#if (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0)
+    /* Packed DTOs go first, the transport layer counter has to be consecutive. */
+    XcpTl_FlushPacked(true);
+#endif /* (XCP_DAQ_TRANSMIT_BATCH_SIZE > 1) && (XCP_ETH_PACKET_SIZE > 0) */
+    XcpTl_Transmit(buf, len);
+    XCP_TL_LEAVE_CRITICAL();
+}
+
+/*
+ * Sends a message (or several packed ones) as is, the caller holds the TL lock.
+ */
+void XcpTl_Transmit(uint8_t const *buf, uint16_t len) {
     if (XcpTl_Connection.socketType == SOCK_DGRAM) {
         if (sendto(
                 XcpTl_Connection.boundSocket, (char const *)buf, len, 0,
@@ -378,8 +390,24 @@ void XcpTl_Send(uint8_t const *buf, uint16_t len) {
             }
         }
     }
+}
+
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+void XcpTl_SendBatch(XcpTl_FrameType const *frames, uint16_t count) {
+    #if XCP_ETH_PACKET_SIZE > 0
+    XCP_TL_ENTER_CRITICAL();
+    XcpTl_PackFrames(frames, count);
     XCP_TL_LEAVE_CRITICAL();
+    #else
+    uint16_t idx = 0;
+
+    /* No sendmmsg() counterpart, frames are sent one by one. */
+    for (idx = 0; idx < count; ++idx) {
+        XcpTl_Send(frames[idx].data, frames[idx].len);
+    }
+    #endif /* XCP_ETH_PACKET_SIZE */
 }
+#endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
 
 #if (XCP_ENABLE_ETH_DISCOVERY == XCP_ON) || (defined(XCP_ENABLE_TIME_CORRELATION) && (XCP_ENABLE_TIME_CORRELATION == XCP_ON))
 
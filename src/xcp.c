@@ -57,7 +57,7 @@ XCP_STATIC Xcp_ConnectionStateType Xcp_ConnectionState = XCP_DISCONNECTED;
 XCP_STATIC Xcp_StateType           Xcp_State;
 XCP_STATIC Xcp_SendCalloutType     Xcp_SendCallout                                       = (Xcp_SendCalloutType)XCP_NULL;
 static uint8_t                     Xcp_CtoOutBuffer[XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE] = { 0 };
-static uint8_t                     Xcp_CtoInBuffer[XCP_TRANSPORT_LAYER_CTO_BUFFER_SIZE]  = { 0 };
+static uint8_t                     Xcp_CtoInBuffer[XCP_TRANSPORT_LAYER_RX_BUFFER_SIZE]   = { 0 };
 
 /*
 **  Global Variables.
@@ -268,7 +268,23 @@ void Xcp_TransportLayerCmd_Res(Xcp_PduType const * const pdu);
 XCP_STATIC
 
 void Xcp_UserCmd_Res(Xcp_PduType const * const pdu);
-#endif /* XCP_ENABLE_USER_CMD */
+    #if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+
+XCP_STATIC
+
+void Xcp_SetDaqPacking_Res(Xcp_PduType const * const pdu);
+
+XCP_STATIC
+
+void Xcp_GetDaqEntryPosition_Res(Xcp_PduType const * const pdu);
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+
+XCP_STATIC
+
+void Xcp_GetDaqLatencies_Res(Xcp_PduType const * const pdu);
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#endif     /* XCP_ENABLE_USER_CMD */
 
 #if XCP_ENABLE_CAL_COMMANDS == XCP_ON
 
@@ -886,6 +902,10 @@ void Xcp_MainFunction(void) {
     Xcp_ChecksumMainFunction();
 #endif /* (XCP_ENABLE_BUILD_CHECKSUM) && (XCP_CHECKSUM_CHUNKED_CALCULATION ==                                                      \
       XCP_ON) */
+
+#if (XCP_ENABLE_DAQ_COMMANDS == XCP_ON) && (XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_ON)
+    XcpDaq_TransmitDtos();
+#endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
     // XcpHw_Sleep(XCP_MAIN_FUNCTION_PERIOD);
 }
 
@@ -936,23 +956,40 @@ uint32_t Xcp_DtoCanId = 0;
     #endif
 
 void Xcp_SendDto(void) {
-    #if XCP_TRANSPORT_LAYER_LENGTH_SIZE != 0
-    const uint16_t len = Xcp_DtoOut.len;
-    #endif /* XCP_TRANSPORT_LAYER_LENGTH_SIZE */
+    Xcp_SendDtoBuffer(Xcp_GetDtoOutPtr(), Xcp_DtoOut.len);
+}
+
+/** @brief Frames and sends a DTO without copying it.
+ *
+ *  @param dto  DTO to send; the XCP_TRANSPORT_LAYER_BUFFER_OFFSET bytes in front of it
+ *              must be writable, the transport layer header is placed there.
+ *  @param len  Length of the DTO (without transport layer header).
+ */
+void Xcp_SendDtoBuffer(uint8_t *dto, uint16_t len) {
+    XcpTl_Send(dto - XCP_TRANSPORT_LAYER_BUFFER_OFFSET, Xcp_FrameDto(dto, len));
+}
+
+/** @brief Places the transport layer header (incl. counter) in front of a DTO, see Xcp_SendDtoBuffer().
+ *
+ *  @return Length of the frame, which starts XCP_TRANSPORT_LAYER_BUFFER_OFFSET bytes in front of `dto`.
+ *  @note   Frames must be sent in the order they were framed, the counter is consecutive.
+ */
+uint16_t Xcp_FrameDto(uint8_t *dto, uint16_t len) {
+    uint8_t *frame = dto - XCP_TRANSPORT_LAYER_BUFFER_OFFSET;
 
     #if XCP_TRANSPORT_LAYER_LENGTH_SIZE == 1
-    Xcp_DtoOut.data[0] = XCP_LOBYTE(len);
+    frame[0] = XCP_LOBYTE(len);
     #elif XCP_TRANSPORT_LAYER_LENGTH_SIZE == 2
-    Xcp_DtoOut.data[0] = XCP_LOBYTE(len);
-    Xcp_DtoOut.data[1] = XCP_HIBYTE(len);
+    frame[0] = XCP_LOBYTE(len);
+    frame[1] = XCP_HIBYTE(len);
     #endif /* XCP_TRANSPORT_LAYER_LENGTH_SIZE */
 
     #if XCP_TRANSPORT_LAYER_COUNTER_SIZE == 1
-    Xcp_DtoOut.data[XCP_TRANSPORT_LAYER_LENGTH_SIZE] = XCP_LOBYTE(Xcp_State.counter);
+    frame[XCP_TRANSPORT_LAYER_LENGTH_SIZE] = XCP_LOBYTE(Xcp_State.counter);
     Xcp_State.counter++;
     #elif XCP_TRANSPORT_LAYER_COUNTER_SIZE == 2
-    Xcp_DtoOut.data[XCP_TRANSPORT_LAYER_LENGTH_SIZE]     = XCP_LOBYTE(Xcp_State.counter);
-    Xcp_DtoOut.data[XCP_TRANSPORT_LAYER_LENGTH_SIZE + 1] = XCP_HIBYTE(Xcp_State.counter);
+    frame[XCP_TRANSPORT_LAYER_LENGTH_SIZE]     = XCP_LOBYTE(Xcp_State.counter);
+    frame[XCP_TRANSPORT_LAYER_LENGTH_SIZE + 1] = XCP_HIBYTE(Xcp_State.counter);
     Xcp_State.counter++;
     #endif /* XCP_TRANSPORT_LAYER_COUNTER_SIZE */
 
@@ -960,7 +997,7 @@ void Xcp_SendDto(void) {
     Xcp_State.statistics.crosSend++;
     #endif /* XCP_ENABLE_STATISTICS */
 
-    XcpTl_Send(Xcp_DtoOut.data, Xcp_DtoOut.len + (uint16_t)XCP_TRANSPORT_LAYER_BUFFER_OFFSET);
+    return len + (uint16_t)XCP_TRANSPORT_LAYER_BUFFER_OFFSET;
 }
 
 uint8_t *Xcp_GetDtoOutPtr(void) {
@@ -1129,6 +1166,15 @@ void Xcp_DispatchCommand(Xcp_PduType const * const pdu) {
     if (Xcp_State.connected == (bool)XCP_TRUE) {
         /*DBG_PRINT2("CMD: [%02X]\n\r", cmd); */
 
+#if XCP_ENABLE_STIM == XCP_ON
+        if (cmd < 0xc0) {
+            /* STIM DTO: staged right away, never answered (and thus never busy). */
+            if (!Xcp_IsProtected(XCP_RESOURCE_STIM)) {
+                XcpDaq_StimReceive(pdu->data, pdu->len);
+            }
+            return;
+        }
+#endif /* XCP_ENABLE_STIM */
         if (Xcp_IsBusy()) {
             Xcp_BusyResponse();
             return;
@@ -1613,9 +1659,119 @@ XCP_STATIC void Xcp_TransportLayerCmd_Res(Xcp_PduType const * const pdu) {
 
 #if XCP_ENABLE_USER_CMD
 XCP_STATIC void Xcp_UserCmd_Res(Xcp_PduType const * const pdu) {
+    const uint8_t subCommand = Xcp_GetByte(pdu, UINT8(1));
+
+    DBG_TRACE("USER_CMD [sub: 0x%02x]\n\r", subCommand);
     XCP_ASSERT_PGM_IDLE();
+
+    switch (subCommand) {
+    #if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+        case XCP_USER_CMD_SET_DAQ_PACKING:
+            Xcp_SetDaqPacking_Res(pdu);
+            break;
+        case XCP_USER_CMD_GET_DAQ_ENTRY_POSITION:
+            Xcp_GetDaqEntryPosition_Res(pdu);
+            break;
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+        case XCP_USER_CMD_GET_DAQ_LATENCIES:
+            Xcp_GetDaqLatencies_Res(pdu);
+            break;
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+        default:
+            Xcp_ErrorResponse(UINT8(ERR_CMD_UNKNOWN));
+            break;
+    }
+}
+
+    #if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+/*
+** [USER_CMD] [SET_DAQ_PACKING] [mode (0: off, 1: packed)] [reserved] [DAQ list (word)]
+*/
+XCP_STATIC void Xcp_SetDaqPacking_Res(Xcp_PduType const * const pdu) {
+    const uint8_t                mode          = Xcp_GetByte(pdu, UINT8(2));
+    const XcpDaq_ListIntegerType daqListNumber = (XcpDaq_ListIntegerType)Xcp_GetWord(pdu, UINT8(4));
+
+    DBG_TRACE("SET_DAQ_PACKING [daq: %u mode: %u]\n\r", daqListNumber, mode);
+    XCP_ASSERT_UNLOCKED(XCP_RESOURCE_DAQ);
+
+    if (mode > UINT8(1)) {
+        Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
+        return;
+    }
+    Xcp_SendResult(XcpDaq_SetListPacking(daqListNumber, (bool)(mode == UINT8(1))));
+}
+
+/*
+** [USER_CMD] [GET_DAQ_ENTRY_POSITION] [ODT] [ODT entry] [DAQ list (word)]
+**  -> [RES] [PID] [offset within DTO (word)]
+*/
+XCP_STATIC void Xcp_GetDaqEntryPosition_Res(Xcp_PduType const * const pdu) {
+    const XcpDaq_ODTIntegerType      odtNumber      = (XcpDaq_ODTIntegerType)Xcp_GetByte(pdu, UINT8(2));
+    const XcpDaq_ODTEntryIntegerType odtEntryNumber = (XcpDaq_ODTEntryIntegerType)Xcp_GetByte(pdu, UINT8(3));
+    const XcpDaq_ListIntegerType     daqListNumber  = (XcpDaq_ListIntegerType)Xcp_GetWord(pdu, UINT8(4));
+    XcpDaq_ODTIntegerType            pid            = 0;
+    uint16_t                         offset         = UINT16(0);
+
+    DBG_TRACE("GET_DAQ_ENTRY_POSITION [daq: %u odt: %u entry: %u]\n\r", daqListNumber, odtNumber, odtEntryNumber);
+    XCP_ASSERT_UNLOCKED(XCP_RESOURCE_DAQ);
+
+    if (!XcpDaq_GetEntryPosition(daqListNumber, odtNumber, odtEntryNumber, &pid, &offset)) {
+        Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
+        return;
+    }
+    Xcp_Send8(
+        UINT8(4), UINT8(XCP_PACKET_IDENTIFIER_RES), UINT8(pid), XCP_LOBYTE(offset), XCP_HIBYTE(offset), UINT8(0), UINT8(0), UINT8(0),
+        UINT8(0)
+    );
 }
-#endif /* XCP_ENABLE_USER_CMD */
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+/*
+** [USER_CMD] [GET_DAQ_LATENCIES] [event channel or 0xff: transport layer] [first bucket]
+**  -> [RES] [number of buckets] [reserved] [reserved] [bucket counts (dwords)]
+**  Buckets that don't fit into one CTO are read by subsequent requests.
+*/
+XCP_STATIC void Xcp_GetDaqLatencies_Res(Xcp_PduType const * const pdu) {
+    const uint8_t                      source      = Xcp_GetByte(pdu, UINT8(2));
+    const uint8_t                      firstBucket = Xcp_GetByte(pdu, UINT8(3));
+    XcpDaq_LatencyHistogramType const *histogram   = &XcpDaq_TransportLatencies;
+    Xcp_PduType                        response    = { 0, Xcp_GetCtoOutPtr() };
+    uint8_t                            numBuckets  = UINT8(0);
+    uint8_t                            idx         = UINT8(0);
+
+    DBG_TRACE("GET_DAQ_LATENCIES [source: %u first: %u]\n\r", source, firstBucket);
+    XCP_ASSERT_UNLOCKED(XCP_RESOURCE_DAQ);
+
+    if (source != XCP_DAQ_LATENCY_TRANSPORT) {
+        if (source >= UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
+            Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
+            return;
+        }
+        histogram = &XcpDaq_EventLatencies[source];
+    }
+    if (firstBucket >= UINT8(XCP_DAQ_LATENCY_BUCKETS)) {
+        Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
+        return;
+    }
+    numBuckets = UINT8(XCP_MIN(UINT8(XCP_DAQ_LATENCY_BUCKETS) - firstBucket, (XCP_MAX_CTO - 4) / 4));
+    Xcp_SetByte(&response, UINT8(0), UINT8(XCP_PACKET_IDENTIFIER_RES));
+    Xcp_SetByte(&response, UINT8(1), numBuckets);
+    Xcp_SetByte(&response, UINT8(2), UINT8(0));
+    Xcp_SetByte(&response, UINT8(3), UINT8(0));
+    for (idx = UINT8(0); idx < numBuckets; ++idx) {
+        Xcp_SetDWord(&response, UINT8(4) + (idx * UINT8(4)), histogram->buckets[firstBucket + idx]);
+    }
+        #if XCP_ON_CAN_MAX_DLC_REQUIRED == XCP_ON
+    Xcp_SetCtoOutLen(UINT16(XCP_MAX_CTO));
+        #else
+    Xcp_SetCtoOutLen(UINT16(4) + (UINT16(numBuckets) * UINT16(4)));
+        #endif /* XCP_ON_CAN_MAX_DLC_REQUIRED */
+    Xcp_SendCto();
+}
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#endif     /* XCP_ENABLE_USER_CMD */
 
 /*
 **
@@ -2052,6 +2208,10 @@ void Xcp_WriteDaq_Res(Xcp_PduType const * const pdu) {
         return;
     }
     #endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS */
+    if (!XcpDaq_ValidateEntrySize(elemSize)) {
+        Xcp_SendResult(ERR_OUT_OF_RANGE); /* ODT wouldn't fit into a DTO. */
+        return;
+    }
     XcpDaq_WriteEntry(bitOffset, elemSize, adddrExt, address);
     Xcp_PositiveResponse();
 }
@@ -2090,6 +2250,10 @@ void Xcp_WriteDaqMultiple_Res(Xcp_PduType const * const pdu) {
         elemSize   = Xcp_GetByte(pdu, daq_offset + UINT8(1));
         address    = Xcp_GetDWord(pdu, daq_offset + UINT8(2));
         adddrExt   = Xcp_GetByte(pdu, daq_offset + UINT8(6));
+        if (!XcpDaq_ValidateEntrySize(elemSize)) {
+            Xcp_SendResult(ERR_OUT_OF_RANGE); /* ODT wouldn't fit into a DTO. */
+            return;
+        }
         XcpDaq_WriteEntry(bitOffset, elemSize, adddrExt, address);
     }
     Xcp_PositiveResponse();
@@ -2136,24 +2300,17 @@ void Xcp_SetDaqListMode_Res(Xcp_PduType const * const pdu) {
         return;
     }
     #endif /* XCP_DAQ_ENABLE_ALTERNATING */
-    #if XCP_DAQ_PRIORITIZATION_SUPPORTED == XCP_OFF
-        /* Needs to be 0 */
-
-        #if 0  // Ignored for now.
-    if (priority > UINT8(0)) {
-        Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
-        return;
-    }
-        #endif
-
-    #endif /* XCP_DAQ_ENABLE_PRIORITIZATION */
-    #if XCP_DAQ_PRESCALER_SUPPORTED == XCP_OFF
+    #if XCP_DAQ_ENABLE_PRESCALER == XCP_OFF
     /* Needs to be 1 */
     if (prescaler > UINT8(1)) {
         Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE));
         return;
     }
     #endif /* XCP_DAQ_ENABLE_PRESCALER */
+    if (!XcpDaq_ValidateListSize(daqListNumber, mode)) {
+        Xcp_ErrorResponse(UINT8(ERR_OUT_OF_RANGE)); /* ODTs wouldn't fit into DTOs (timestamp). */
+        return;
+    }
 
     XcpDaq_SetListMode(daqListNumber, mode, eventChannelNumber, prescaler, priority);
 
@@ -2165,6 +2322,8 @@ XCP_STATIC
 void Xcp_GetDaqListMode_Res(Xcp_PduType const * const pdu) {
     XcpDaq_ListStateType        *entry         = XCP_NULL;
     const XcpDaq_ListIntegerType daqListNumber = (XcpDaq_ListIntegerType)Xcp_GetWord(pdu, UINT8(2));
+    uint16_t                     eventChannel  = UINT16(0);
+    uint8_t                      prescaler     = UINT8(1);
 
     DBG_TRACE("GET_DAQ_LIST_MODE\n\r");
     XCP_ASSERT_PGM_IDLE();
@@ -2176,16 +2335,19 @@ void Xcp_GetDaqListMode_Res(Xcp_PduType const * const pdu) {
     }
 
     entry = XcpDaq_GetListState(daqListNumber);
+    if (entry->eventChannel != XCP_DAQ_NO_EVENT_CHANNEL) {
+        eventChannel = entry->eventChannel;
+    }
+    #if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
+    prescaler = entry->prescaler;
+    #endif /* XCP_DAQ_ENABLE_PRESCALER */
 
     Xcp_Send8(
         UINT8(8), UINT8(XCP_PACKET_IDENTIFIER_RES), UINT8(entry->mode), UINT8(0), UINT8(0),
-
-        // XCP_LOBYTE(UINT16(XCP_DAQ_MAX_EVENT_CHANNEL)), XCP_HIBYTE(UINT16(XCP_DAQ_MAX_EVENT_CHANNEL)),
-
-        UINT8(0),  // WORD    Current Event Channel Number
-        UINT8(0),
-        UINT8(1),  // BYTE    Current Prescaler
-        UINT8(0)   // BYTE    Current DAQ list Priority
+        XCP_LOBYTE(eventChannel), // WORD    Current Event Channel Number
+        XCP_HIBYTE(eventChannel),
+        UINT8(prescaler),         // BYTE    Current Prescaler
+        UINT8(entry->priority)    // BYTE    Current DAQ list Priority
     );
 }
 
@@ -2195,6 +2357,7 @@ void Xcp_StartStopDaqList_Res(Xcp_PduType const * const pdu) {
     const uint8_t                mode          = Xcp_GetByte(pdu, UINT8(1));
     XcpDaq_ODTIntegerType        firstPid      = (XcpDaq_ODTIntegerType)0;
     const XcpDaq_ListIntegerType daqListNumber = (XcpDaq_ListIntegerType)Xcp_GetWord(pdu, UINT8(2));
+    Xcp_ReturnType               result        = ERR_SUCCESS;
 
     DBG_TRACE("START_STOP_DAQ_LIST [mode: 0x%02x daq: %03u]\n\r", mode, daqListNumber);
     XCP_ASSERT_PGM_IDLE();
@@ -2209,8 +2372,16 @@ void Xcp_StartStopDaqList_Res(Xcp_PduType const * const pdu) {
         Xcp_ErrorResponse(UINT8(ERR_MODE_NOT_VALID));
         return;
     }
+    if ((mode != UINT8(0)) && !XcpDaq_ValidateListSize(daqListNumber, XcpDaq_GetListState(daqListNumber)->mode)) {
+        Xcp_ErrorResponse(UINT8(ERR_DAQ_CONFIG));
+        return;
+    }
 
-    XcpDaq_StartStopSingleList(daqListNumber, mode);
+    result = XcpDaq_StartStopSingleList(daqListNumber, mode);
+    if (result != ERR_SUCCESS) {
+        Xcp_ErrorResponse(UINT8(result));
+        return;
+    }
     XcpDaq_GetFirstPid(daqListNumber, &firstPid);
 
     Xcp_Send8(UINT8(8), UINT8(XCP_PACKET_IDENTIFIER_RES), firstPid, UINT8(0), UINT8(0), UINT8(0), UINT8(0), UINT8(0), UINT8(0));
@@ -2219,7 +2390,8 @@ void Xcp_StartStopDaqList_Res(Xcp_PduType const * const pdu) {
 XCP_STATIC
 
 void Xcp_StartStopSynch_Res(Xcp_PduType const * const pdu) {
-    const uint8_t mode = Xcp_GetByte(pdu, UINT8(1));
+    const uint8_t  mode   = Xcp_GetByte(pdu, UINT8(1));
+    Xcp_ReturnType result = ERR_SUCCESS;
 
     DBG_TRACE("START_STOP_SYNCH [mode: 0x%02x]\n\r", mode);
     XCP_ASSERT_PGM_IDLE();
@@ -2230,9 +2402,13 @@ void Xcp_StartStopSynch_Res(Xcp_PduType const * const pdu) {
         return;
     }
     if ((mode == 3) || (mode == 2)) {
-        XcpDaq_StartStopSynch(2);
+        result = XcpDaq_StartStopSynch(2);
     } else {
-        XcpDaq_StartStopSynch(mode);
+        result = XcpDaq_StartStopSynch(mode);
+    }
+    if (result != ERR_SUCCESS) {
+        Xcp_ErrorResponse(UINT8(result));
+        return;
     }
 
     Xcp_PositiveResponse();
@@ -2293,6 +2469,9 @@ void Xcp_GetDaqListInfo_Res(Xcp_PduType const * const pdu) {
     properties |= DAQ_LIST_PROPERTY_PREDEFINED;  /* Hardcoded for now. */
     properties |= DAQ_LIST_PROPERTY_EVENT_FIXED; /* "                " */
     properties |= DAQ_LIST_PROPERTY_DAQ;         /* "                " */
+        #if XCP_ENABLE_STIM == XCP_ON
+    properties |= DAQ_LIST_PROPERTY_STIM;
+        #endif /* XCP_ENABLE_STIM */
 
         #if XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON
     Xcp_Send8(
@@ -2426,7 +2605,7 @@ void Xcp_GetDaqResolutionInfo_Res(Xcp_PduType const * const pdu) {
         UINT8(XCP_DAQ_MAX_ODT_ENTRY_SIZE),                    /* Maximum size of ODT entry (DIRECTION = DAQ) */
         UINT8(1),                                             /* Granularity for size of ODT entry (DIRECTION = STIM) */
         UINT8(XCP_DAQ_MAX_ODT_ENTRY_SIZE),                    /* Maximum size of ODT entry (DIRECTION = STIM) */
-        UINT8(0x34),                                          /* Timestamp unit and size */
+        UINT8(XCP_DAQ_TIMESTAMP_MODE),                        /* Timestamp unit and size */
         UINT8(1),                                             /* Timestamp ticks per unit (WORD) */
         UINT8(0)
     );
@@ -2442,6 +2621,8 @@ void Xcp_GetDaqEventInfo_Res(Xcp_PduType const * const pdu) {
     uint16_t                eventChannel = Xcp_GetWord(pdu, UINT8(2));
     uint8_t                 nameLen      = UINT8(0);
     XcpDaq_EventType const *event        = XCP_NULL;
+    uint8_t                 cycle        = UINT8(0);
+    uint8_t                 timeunit     = UINT8(0);
 
     DBG_TRACE("GET_DAQ_EVENT_INFO [eventChannel: %d]\n\r", eventChannel);
     XCP_ASSERT_UNLOCKED(XCP_RESOURCE_DAQ);
@@ -2457,14 +2638,24 @@ void Xcp_GetDaqEventInfo_Res(Xcp_PduType const * const pdu) {
         nameLen = event->nameLen;
         Xcp_SetMta(Xcp_GetNonPagedAddress(event->name));
     }
+        #if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+    XcpDaq_GetEffectiveEventCycle(eventChannel, &cycle, &timeunit);
+        #else
+    cycle    = event->cycle;
+    timeunit = event->timeunit;
+        #endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
 
     Xcp_Send8(
         UINT8(7), UINT8(XCP_PACKET_IDENTIFIER_RES), UINT8(event->properties), /* DAQ_EVENT_PROPERTIES */
+        #if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+        UINT8(0xff),            /* maximum number of DAQ lists in this event channel (0xff: unlimited) */
+        #else
         UINT8(1),               /* maximum number of DAQ lists in this event channel */
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
         UINT8(nameLen),         /* EVENT_CHANNEL_NAME_LENGTH in bytes 0 – If not
                                                  available */
-        UINT8(event->cycle),    /* EVENT_CHANNEL_TIME_CYCLE 0 – Not cyclic */
-        UINT8(event->timeunit), /* EVENT_CHANNEL_TIME_UNIT don’t care if
+        UINT8(cycle),           /* EVENT_CHANNEL_TIME_CYCLE 0 – Not cyclic */
+        UINT8(timeunit),        /* EVENT_CHANNEL_TIME_UNIT don’t care if
                                  Event channel time cycle = 0 */
         UINT8(0),               /* EVENT_CHANNEL_PRIORITY (FF highest) */
         UINT8(0)
@@ -34,6 +34,16 @@
 #endif /* _WIN32 */
 #include <inttypes.h>
 
+/*
+** The DTO queue is a lock-free SPSC (or MPSC) ring if C11 atomics are available.
+*/
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+    #include <stdatomic.h>
+    #define XCP_DAQ_QUEUE_ATOMICS (XCP_ON)
+#else
+    #define XCP_DAQ_QUEUE_ATOMICS (XCP_OFF)
+#endif
+
 /*!!! START-INCLUDE-SECTION !!!*/
 #include "xcp.h"
 #include "xcp_util.h"
@@ -43,18 +53,232 @@
 /*
 ** Private Parameters for now.
 */
+#define XCP_DAQ_OVERLOAD_PID_MSB UINT8(0x80)
+#define XCP_DAQ_STIM_PID_LIMIT   (0xc0) /* Packets with PIDs from here on are commands. */
+#define XCP_DAQ_STIM_FRESH       UINT8(0x80)
+
+#if (XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON) || (XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON)
+    #if XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_1
+        #define XCP_DAQ_TIMER_MASK UINT32(0x000000ff)
+    #elif XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_2
+        #define XCP_DAQ_TIMER_MASK UINT32(0x0000ffff)
+    #else
+        #define XCP_DAQ_TIMER_MASK UINT32(0xffffffff)
+    #endif /* XCP_DAQ_TIMESTAMP_SIZE */
+#endif     /* (XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON) || (XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON) */
+
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    #define XCP_DAQ_LATENCY_NO_EVENT UINT8(0xff) /* DTO wasn't sampled by an event. */
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
+#if XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT == XCP_ON
+    #define XCP_DAQ_TIMESTAMPED_DTO(dto) ((bool)XCP_TRUE)
+#else
+    #define XCP_DAQ_TIMESTAMPED_DTO(dto) ((bool)((dto) == (XcpDaq_ODTIntegerType)0))
+#endif /* XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT */
 
 /*
 ** Local Types.
 */
+#if XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_8
+typedef uint64_t XcpDaq_TimestampType;
+#else
+typedef uint32_t XcpDaq_TimestampType;
+#endif /* XCP_DAQ_TIMESTAMP_SIZE */
+
+#if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_OFF
+        #error XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS requires C11 atomics
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+    #if XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_OFF
+        #error XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS requires XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION
+    #endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+typedef uint32_t XcpDaq_QueuePositionType; /* Wide enough to rule out ABA on `head`. */
+#else
+typedef XCP_DAQ_QUEUE_INDEX_TYPE XcpDaq_QueuePositionType;
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_OFF
+        #error XCP_DAQ_ENABLE_ASYNC_SAMPLING requires C11 atomics
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_OFF
+        /* The DAQ worker and synchronously sampling event contexts fill the DTO queue side by side. */
+        #error XCP_DAQ_ENABLE_ASYNC_SAMPLING requires XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+#endif     /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+    #if XCP_TRANSPORT_LAYER != XCP_ON_ETHERNET
+        #error XCP_DAQ_TRANSMIT_BATCH_SIZE > 1 requires XCP_ON_ETHERNET
+    #endif /* XCP_TRANSPORT_LAYER */
+    #if XCP_DAQ_TRANSMIT_BATCH_SIZE > XCP_DAQ_PRIORITY_QUEUE_SIZE
+        #error XCP_DAQ_TRANSMIT_BATCH_SIZE must not exceed XCP_DAQ_PRIORITY_QUEUE_SIZE
+    #endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE > XCP_DAQ_PRIORITY_QUEUE_SIZE */
+#endif     /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
+#if XCP_DAQ_QUEUE_ATOMICS == XCP_ON
+typedef _Atomic(XcpDaq_QueuePositionType) XcpDaq_QueueIndexType;
+
+    #define XcpDaq_QueueLoad(idx)              ((XcpDaq_QueuePositionType)atomic_load_explicit(&(idx), memory_order_relaxed))
+    #define XcpDaq_QueueLoadAcquire(idx)       ((XcpDaq_QueuePositionType)atomic_load_explicit(&(idx), memory_order_acquire))
+    #define XcpDaq_QueueStore(idx, val)        atomic_store_explicit(&(idx), (val), memory_order_relaxed)
+    #define XcpDaq_QueueStoreRelease(idx, val) atomic_store_explicit(&(idx), (val), memory_order_release)
+    #define XcpDaq_QueueIncrement(idx)         ((void)atomic_fetch_add_explicit(&(idx), 1U, memory_order_relaxed))
+    #define XcpDaq_QueueDecrement(idx)         ((void)atomic_fetch_sub_explicit(&(idx), 1U, memory_order_relaxed))
+    #define XcpDaq_QueueDecrementRelease(idx)  ((void)atomic_fetch_sub_explicit(&(idx), 1U, memory_order_release))
+    #define XcpDaq_QueueFence()                atomic_thread_fence(memory_order_seq_cst)
+#else
+typedef volatile XcpDaq_QueuePositionType XcpDaq_QueueIndexType;
+
+    #define XcpDaq_QueueLoad(idx)              ((XcpDaq_QueuePositionType)(idx))
+    #define XcpDaq_QueueLoadAcquire(idx)       ((XcpDaq_QueuePositionType)(idx))
+    #define XcpDaq_QueueStore(idx, val)        ((idx) = (val))
+    #define XcpDaq_QueueStoreRelease(idx, val) ((idx) = (val))
+    #define XcpDaq_QueueIncrement(idx)         ((idx)++)
+    #define XcpDaq_QueueDecrement(idx)         ((idx)--)
+    #define XcpDaq_QueueDecrementRelease(idx)  ((idx)--)
+    #define XcpDaq_QueueFence()
+#endif /* XCP_DAQ_QUEUE_ATOMICS */
+
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_ON
+typedef _Atomic(uint32_t) XcpDaq_SnapshotCounterType;
+
+        #define XcpDaq_SnapshotLoad(cnt)      ((uint32_t)atomic_load(&(cnt)))
+        #define XcpDaq_SnapshotIncrement(cnt) ((void)atomic_fetch_add(&(cnt), 1U))
+        #define XcpDaq_SnapshotDecrement(cnt) ((void)atomic_fetch_sub(&(cnt), 1U))
+        #define XcpDaq_SnapshotFence()        atomic_thread_fence(memory_order_acquire)
+    #else
+typedef volatile uint32_t XcpDaq_SnapshotCounterType;
+
+        #define XcpDaq_SnapshotLoad(cnt)      ((uint32_t)(cnt))
+        #define XcpDaq_SnapshotIncrement(cnt) ((cnt)++)
+        #define XcpDaq_SnapshotDecrement(cnt) ((cnt)--)
+        #define XcpDaq_SnapshotFence()
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+#endif     /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+#if XCP_ENABLE_STIM == XCP_ON
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_ON
+typedef _Atomic(uint8_t) XcpDaq_StimImageType;
+
+        #define XcpDaq_StimLoad(img)          ((uint8_t)atomic_load_explicit(&(img), memory_order_relaxed))
+        #define XcpDaq_StimExchange(img, val) ((uint8_t)atomic_exchange_explicit(&(img), (val), memory_order_acq_rel))
+        /* Same, but from within XCP_STIM_ENTER_CRITICAL(). */
+        #define XcpDaq_StimExchangeHeld(img, val) XcpDaq_StimExchange(img, val)
+    #else
+typedef volatile uint8_t XcpDaq_StimImageType;
+
+        #define XcpDaq_StimLoad(img)          ((uint8_t)(img))
+        #define XcpDaq_StimExchange(img, val)     XcpDaq_StimExchangeLocked(&(img), (val))
+        #define XcpDaq_StimExchangeHeld(img, val) XcpDaq_StimSwap(&(img), (val))
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+
+/*
+** STIM DTOs of a DAQ list are received into one of three images (triple buffering):
+** the receiver fills `receiving`, the event applies `applying`, and complete images are handed
+** over through `latest` -- neither side ever waits for the other.
+*/
+typedef struct tagXcpDaq_StimStateType {
+    uint32_t              images; /* Offset of the list's images within XcpDaq_StimBuffers. */
+    uint8_t               receiving;
+    uint8_t               applying;
+    XcpDaq_StimImageType  latest; /* Last complete image, XCP_DAQ_STIM_FRESH while not applied yet. */
+    XcpDaq_ODTIntegerType nextOdt;
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    uint32_t receivedAt[3]; /* Completion time of each image. */
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+} XcpDaq_StimStateType;
+#endif /* XCP_ENABLE_STIM */
+
+/*
+** Links of the event channel chains. Triggers walk them without a lock, so a list is linked in
+** only after its own link is set, see XcpDaq_AddEventChannel().
+*/
+#if XCP_DAQ_QUEUE_ATOMICS == XCP_ON
+typedef _Atomic(XcpDaq_ListIntegerType) XcpDaq_ListLinkType;
+
+    #define XcpDaq_LinkLoad(link)       ((XcpDaq_ListIntegerType)atomic_load_explicit(&(link), memory_order_acquire))
+    #define XcpDaq_LinkStore(link, val) atomic_store_explicit(&(link), (val), memory_order_release)
+#else
+typedef volatile XcpDaq_ListIntegerType XcpDaq_ListLinkType;
+
+    #define XcpDaq_LinkLoad(link)       ((XcpDaq_ListIntegerType)(link))
+    #define XcpDaq_LinkStore(link, val) ((link) = (val))
+#endif /* XCP_DAQ_QUEUE_ATOMICS */
+
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+typedef struct tagXcpDaq_EventRateStateType {
+    uint32_t lastOccurrence; /* Time of the last processed occurrence. */
+    uint8_t  counter;        /* Occurrences skipped by the prescaler. */
+    bool     processed;      /* `lastOccurrence` is valid. */
+} XcpDaq_EventRateStateType;
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+/*
+** Round trip of a bypass event: DAQ lists sampled at one occurrence, the STIM data
+** has to be back (i.e. is applied) at the next one.
+*/
+typedef struct tagXcpDaq_RoundTripType {
+    uint32_t sampledAt;  /* Start of the pending round trip. */
+    uint32_t receivedAt; /* Latest completion time of the STIM images applied by the current occurrence. */
+    uint16_t stimLists;  /* Started STIM lists of the event. */
+    uint16_t stimImages; /* STIM lists that got new data. */
+    bool     pending;
+} XcpDaq_RoundTripType;
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+
+#define XCP_DAQ_QUEUE_SLOT(level, pos)                                                                                        \
+    (&XcpDaq_QueueDTOs[(level)][(pos) & (XcpDaq_QueuePositionType)(XCP_DAQ_PRIORITY_QUEUE_SIZE - 1)])
+
 typedef struct {
+#if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    /*
+    ** Slot state relative to the lap base `pos & ~(XCP_DAQ_PRIORITY_QUEUE_SIZE - 1)` of the position `pos` the
+    ** slot is used for: +0: free, +1: committed (ready to send), +XCP_DAQ_PRIORITY_QUEUE_SIZE: released (free for
+    ** the next lap).
+    ** Being relative, all-zero memory is a valid empty queue.
+    */
+    XcpDaq_QueueIndexType sequence;
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+#if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+    XcpDaq_ListIntegerType owner; /* DAQ list the slot is accounted to, or XCP_DAQ_NO_LIST. */
+#endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    uint32_t sampledAt; /* Time of the event. */
+    uint8_t  event;     /* Event channel or XCP_DAQ_LATENCY_NO_EVENT. */
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
     uint16_t len;
-    uint8_t  data[XCP_MAX_DTO];
+    uint8_t  data[XCP_TRANSPORT_LAYER_DTO_BUFFER_SIZE]; /* Room for the transport layer header, DTOs are sent in place. */
 #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
     uint32_t can_id;
 #endif /* (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN) */
 } XcpDaq_OdtType;
 
+/*
+** Free-running indices, slots are addressed modulo the ring size (power of two).
+** `head` is only written by the producer(s) (event context), `tail` only by the consumer (transmitter).
+*/
+typedef struct tagXcpDaq_RingType {
+    XcpDaq_QueueIndexType head;
+    XcpDaq_QueueIndexType tail;
+} XcpDaq_RingType;
+
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    #define XCP_DAQ_EVENT_RECORD(pos) (&XcpDaq_EventRecords[(pos) & (XcpDaq_QueuePositionType)(XCP_DAQ_QUEUE_SIZE - 1)])
+
+/* Occurrence of an asynchronously sampled event, waiting for the DAQ worker. */
+typedef struct tagXcpDaq_EventRecordType {
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    XcpDaq_QueueIndexType sequence; /* Same protocol as XcpDaq_OdtType::sequence. */
+    #endif                          /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    XcpDaq_TimestampType timestamp;
+    uint8_t              eventChannel;
+} XcpDaq_EventRecordType;
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
 typedef enum tagXcpDaq_AllocResultType {
     DAQ_ALLOC_OK,
     DAQ_ALLOC_ERR
@@ -80,17 +304,160 @@ typedef enum tagXcpDaq_ListTransitionType {
     DAQ_LIST_TRANSITION_STOP
 } XcpDaq_ListTransitionType;
 
+/*
+** Sampling plans are flattened copies of the DAQ configuration, compiled at
+** start time, so the event path doesn't need to resolve lists, ODTs, and entries.
+*/
+typedef struct tagXcpDaq_PlanEntryType {
+    Xcp_PointerSizeType src;
+    uint16_t            length;
+    uint16_t            offset; /* Destination offset within DTO. */
+} XcpDaq_PlanEntryType;
+
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+/*
+** Consecutive bits of one byte, transmitted as consecutive DTO bytes (0 or 1 each).
+*/
+typedef struct tagXcpDaq_PlanBitsType {
+    Xcp_PointerSizeType src;
+    uint16_t            offset; /* Destination offset of the first bit within DTO. */
+    uint8_t             shift;  /* Position of the first bit within the source byte. */
+    uint8_t             count;
+} XcpDaq_PlanBitsType;
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+
+typedef struct tagXcpDaq_PlanOdtType {
+    uint16_t firstEntry;
+    uint16_t numEntries;
+    uint16_t length; /* DTO length, incl. identification field and timestamp. */
+    bool     timestamp;
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    uint16_t firstBits;
+    uint16_t numBits;
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON)
+    uint16_t imageOffset; /* Start of the ODT's data within the snapshot / STIM image of its DAQ list. */
+    uint16_t dataOffset;  /* Start of the data within DTO, the image holds the DTO payload as is. */
+#endif /* (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON) */
+} XcpDaq_PlanOdtType;
+
+/*
+** Fill levels of the sampling plan arrays; the plan of a DAQ list occupies [begin, end) of each.
+*/
+typedef struct tagXcpDaq_PlanMarkType {
+    uint16_t odts;
+    uint16_t entries;
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    uint16_t bits;
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_ENABLE_STIM == XCP_ON
+    uint32_t stimBuffer;
+#endif /* XCP_ENABLE_STIM */
+} XcpDaq_PlanMarkType;
+
+typedef struct tagXcpDaq_PlanListType {
+    XcpDaq_PlanMarkType   begin;
+    XcpDaq_PlanMarkType   end;
+    uint16_t              firstOdt;
+    XcpDaq_ODTIntegerType numOdts;
+    XcpDaq_ODTIntegerType firstPid;
+    uint8_t               queue; /* Priority queue the DTOs go to. */
+    bool                  valid;
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    uint16_t snapshotLength; /* Sampled via snapshot if non-zero. */
+#endif                       /* XCP_DAQ_ENABLE_SNAPSHOTS */
+#if XCP_ENABLE_STIM == XCP_ON
+    bool     stim; /* Direction STIM: applied at event time instead of being sampled. */
+    uint16_t imageLength;
+#endif /* XCP_ENABLE_STIM */
+} XcpDaq_PlanListType;
+
 /*
 ** Local Function-like Macros.
 */
 #define XCP_DAQ_MESSAGE_SIZE(msg) UINT16((((msg)->dlc) + sizeof(uint8_t)))
 
+#if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+    #define XCP_DAQ_PID_SIZE UINT16(0)
+#else
+    #define XCP_DAQ_PID_SIZE UINT16(1)
+#endif /* (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN) */
+
 /*
 ** Local Function Prototypes.
 */
 void            XcpDaq_PrintDAQDetails(void);
 XCP_STATIC void XcpDaq_StartStopLists(XcpDaq_ListTransitionType transition);
 XCP_STATIC void XcpDaq_InitMessageQueue(void);
+XCP_STATIC void XcpDaq_InitListState(XcpDaq_ListStateType *state, XcpDaq_ODTIntegerType firstPid);
+XCP_STATIC void XcpDaq_ResetEventChannels(void);
+XCP_STATIC void XcpDaq_RemoveEventChannel(XcpDaq_ListIntegerType daqListNumber);
+XCP_STATIC bool XcpDaq_SampleList(
+    XcpDaq_ListIntegerType daqListNumber, XcpDaq_ListStateType *listState, XcpDaq_TimestampType timestamp
+);
+XCP_STATIC XcpDaq_TimestampType XcpDaq_EventTimestamp(void);
+XCP_STATIC bool                 XcpDaq_DispatchEvent(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp);
+XCP_STATIC void                 XcpDaq_ProcessEvent(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp);
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+XCP_STATIC bool XcpDaq_EventRingPush(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp);
+XCP_STATIC bool XcpDaq_EventRingPop(uint8_t *eventChannelNumber, XcpDaq_TimestampType *timestamp);
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+#if XCP_DAQ_ENABLE_QUEUING == XCP_ON
+XCP_STATIC XcpDaq_OdtType *XcpDaq_QueueSlotFromDto(uint8_t const *dto);
+XCP_STATIC bool            XcpDaq_QueueLevelFull(uint8_t level);
+XCP_STATIC bool            XcpDaq_QueueLevelReady(uint8_t level);
+XCP_STATIC uint8_t        *XcpDaq_QueueReserveLevel(uint8_t level);
+XCP_STATIC bool            XcpDaq_QueueClaim(void);
+XCP_STATIC void            XcpDaq_QueueUnclaim(void);
+XCP_STATIC bool            XcpDaq_QueueDiscard(void);
+XCP_STATIC bool            XcpDaq_QueueEnter(void);
+XCP_STATIC void            XcpDaq_QueueLeave(void);
+XCP_STATIC bool            XcpDaq_QueuePending(void);
+    #if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+XCP_STATIC uint8_t *XcpDaq_QueuePeekAhead(uint16_t ahead, uint16_t *len);
+    #endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+XCP_STATIC uint8_t *XcpDaq_QueueReserveForList(XcpDaq_ListIntegerType daqListNumber, uint8_t level);
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+#endif     /* XCP_DAQ_ENABLE_QUEUING */
+XCP_STATIC void XcpDaq_ResetSamplingPlan(void);
+XCP_STATIC void XcpDaq_ClearSamplingPlan(void);
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileSamplingPlan(XcpDaq_ListIntegerType daqListNumber);
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileListPlan(XcpDaq_ListIntegerType daqListNumber);
+XCP_STATIC bool XcpDaq_AnyListStarted(void);
+XCP_STATIC void XcpDaq_GetPlanMark(XcpDaq_PlanMarkType *mark);
+XCP_STATIC void XcpDaq_SetPlanMark(XcpDaq_PlanMarkType const *mark);
+XCP_STATIC bool XcpDaq_PlanMarkEqual(XcpDaq_PlanMarkType const *mark, XcpDaq_PlanMarkType const *other);
+XCP_STATIC XcpDaq_PlanOdtType *XcpDaq_BeginPlanOdt(XcpDaq_PlanListType *planList, XcpDaq_ListStateType const *listState);
+XCP_STATIC uint16_t            XcpDaq_DtoHeaderLength(uint8_t mode, XcpDaq_ODTIntegerType dto);
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+XCP_STATIC void XcpDaq_RecordLatency(XcpDaq_LatencyHistogramType *histogram, uint32_t ticks);
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+XCP_STATIC bool XcpDaq_PlanContains(uint16_t firstEntry, uint16_t lastEntry, Xcp_PointerSizeType address, uint32_t length);
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+XCP_STATIC bool XcpDaq_CompileBitEntry(XcpDaq_PlanOdtType *planOdt, XcpDaq_ODTEntryType const *entry, uint16_t offset);
+XCP_STATIC void XcpDaq_SampleBits(XcpDaq_PlanOdtType const *planOdt, uint8_t *data, uint16_t dataOffset);
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+XCP_STATIC bool XcpDaq_TakeSnapshot(XcpDaq_PlanListType const *planList, uint8_t *snapshot);
+XCP_STATIC void XcpDaq_SnapshotBackoff(uint8_t attempt);
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+#if XCP_ENABLE_STIM == XCP_ON
+XCP_STATIC void XcpDaq_ResetStim(void);
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileStimPlan(XcpDaq_ListIntegerType daqListNumber, uint32_t imageLength);
+XCP_STATIC void XcpDaq_ApplyStim(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ListStateType const *listState);
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_OFF
+XCP_STATIC uint8_t XcpDaq_StimExchangeLocked(XcpDaq_StimImageType *image, uint8_t value);
+XCP_STATIC uint8_t XcpDaq_StimSwap(XcpDaq_StimImageType *image, uint8_t value);
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+#endif     /* XCP_ENABLE_STIM */
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+XCP_STATIC void XcpDaq_CloseRoundTrip(uint8_t eventChannelNumber, uint32_t timestamp);
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+XCP_STATIC bool XcpDaq_EventDue(uint8_t eventChannelNumber, uint32_t timestamp);
+XCP_STATIC void XcpDaq_NormalizeCycle(uint32_t *cycle, int8_t *decade);
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
 #if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
 XCP_STATIC bool                   XcpDaq_AllocValidateTransition(XcpDaq_AllocTransitionType transition);
 XCP_STATIC XcpDaq_ListIntegerType XcpDaq_GetDynamicListCount(void);
@@ -121,31 +488,130 @@ XCP_STATIC const uint8_t XcpDaq_AllocTransitionTable[5][4] = {
 XCP_STATIC XcpDaq_EntityType XcpDaq_Entities[XCP_DAQ_MAX_DYNAMIC_ENTITIES];
 
 #if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
+/* Indexed by DAQ list number, kept out of XcpDaq_Entities to keep entities small. */
+XCP_STATIC XcpDaq_ListStateType         XcpDaq_DynamicListsState[XCP_DAQ_SAMPLING_PLAN_SIZE];
 XCP_STATIC XcpDaq_AllocStateType        XcpDaq_AllocState;
-XCP_STATIC XcpDaq_ListStateType         XcpDaq_ListState;
 XCP_STATIC XcpDaq_ListConfigurationType XcpDaq_ListConfiguration;
 XCP_STATIC XCP_DAQ_ENTITY_TYPE          XcpDaq_EntityCount = (XCP_DAQ_ENTITY_TYPE)0;
 XCP_STATIC XCP_DAQ_ENTITY_TYPE          XcpDaq_ListCount   = (XCP_DAQ_ENTITY_TYPE)0;
 XCP_STATIC XCP_DAQ_ENTITY_TYPE          XcpDaq_OdtCount    = (XCP_DAQ_ENTITY_TYPE)0;
 #endif /* XCP_DAQ_ENABLE_DYNAMIC_LISTS */
 
+#if XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON
+XCP_STATIC XcpDaq_ODTIntegerType XcpDaq_PredefinedOdtCount = (XcpDaq_ODTIntegerType)0;
+#endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS */
+
 #if XCP_DAQ_ENABLE_QUEUING == XCP_ON
-XCP_STATIC XcpDaq_QueueType XcpDaq_Queue                         = { 0 };
-XCP_STATIC XcpDaq_OdtType   XcpDaq_QueueDTOs[XCP_DAQ_QUEUE_SIZE] = { 0 };
+/*
+** One ring per priority queue (XCP_DAQ_ENABLE_PRIORITIZATION), index 0 is the lowest priority.
+** The queues share the XCP_DAQ_QUEUE_SIZE slots.
+*/
+XCP_STATIC XcpDaq_RingType       XcpDaq_Queue[XCP_DAQ_PRIORITY_QUEUES];
+XCP_STATIC XcpDaq_OdtType        XcpDaq_QueueDTOs[XCP_DAQ_PRIORITY_QUEUES][XCP_DAQ_PRIORITY_QUEUE_SIZE];
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_QueueOverload; /* Non-zero if DTOs were lost. */
+XCP_STATIC uint8_t               XcpDaq_QueuePeeked;   /* Queue of the DTO returned by XcpDaq_QueuePeek(). */
+XCP_STATIC bool                  XcpDaq_QueueConsumed; /* Consumer role is taken, see XcpDaq_QueueClaim(). */
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_QueueDiscards;  /* Discards requested by XcpDaq_QueueInit() ... */
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_QueueDiscarded; /* ... and carried out by the consumer. */
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_QueueProducers; /* Producers between reservation and commit. */
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_QueueClosed;    /* Non-zero while a discard is pending, see XcpDaq_QueueEnter(). */
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+/* Max. number of slots a DAQ list may occupy (0: unlimited) and the number of slots currently occupied. */
+XCP_STATIC XCP_DAQ_QUEUE_INDEX_TYPE XcpDaq_QueueBudgets[XCP_DAQ_SAMPLING_PLAN_SIZE];
+XCP_STATIC XcpDaq_QueueIndexType    XcpDaq_QueueUsage[XCP_DAQ_SAMPLING_PLAN_SIZE];
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
 #endif /* XCP_DAQ_ENABLE_QUEUING */
 
-#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
-XCP_STATIC uint8_t XcpDaq_ListForEvent[XCP_DAQ_MAX_EVENT_CHANNEL];
-#else
-    #error XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT option currently not supported
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+/*
+** Event occurrences recorded by XcpDaq_TriggerEvent() and sampled by the DAQ worker (XcpDaq_ProcessEvents()),
+** same ring discipline as the DTO queue. Not reset by XcpDaq_Init(), the worker may be draining it.
+*/
+XCP_STATIC XcpDaq_RingType          XcpDaq_EventRing;
+XCP_STATIC XcpDaq_EventRecordType   XcpDaq_EventRecords[XCP_DAQ_QUEUE_SIZE];
+XCP_STATIC _Atomic(bool)            XcpDaq_AsyncEvents[XCP_DAQ_MAX_EVENT_CHANNEL]; /* Application setting. */
+XCP_STATIC XcpDaq_WorkerCalloutType XcpDaq_WorkerCallout = (XcpDaq_WorkerCalloutType)XCP_NULL;
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
+XCP_STATIC XcpDaq_PlanListType  XcpDaq_PlanLists[XCP_DAQ_SAMPLING_PLAN_SIZE];
+XCP_STATIC XcpDaq_PlanOdtType   XcpDaq_PlanOdts[XCP_DAQ_SAMPLING_PLAN_ODTS];
+XCP_STATIC XcpDaq_PlanEntryType XcpDaq_PlanEntries[XCP_DAQ_SAMPLING_PLAN_ENTRIES];
+XCP_STATIC uint16_t             XcpDaq_PlanOdtCount   = UINT16(0);
+XCP_STATIC uint16_t             XcpDaq_PlanEntryCount = UINT16(0);
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+XCP_STATIC XcpDaq_PlanBitsType XcpDaq_PlanBits[XCP_DAQ_SAMPLING_PLAN_ENTRIES];
+XCP_STATIC uint16_t            XcpDaq_PlanBitsCount = UINT16(0);
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+XCP_STATIC XcpDaq_PlanStatisticsType XcpDaq_PlanStatistics;
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+/* DAQ lists sampled in packed mode, see XcpDaq_SetListPacking(). */
+XCP_STATIC bool XcpDaq_PackedLists[XCP_DAQ_SAMPLING_PLAN_SIZE];
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+/*
+** DAQ list triggered by an event channel, or XCP_DAQ_NO_LIST; with multiple DAQ lists
+** per event this is the head of a chain (linked by XcpDaq_NextList), ordered by priority.
+*/
+XCP_STATIC XcpDaq_ListLinkType XcpDaq_ListForEvent[XCP_DAQ_MAX_EVENT_CHANNEL];
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+/* Next list triggered by the same event channel, indexed by DAQ list number. */
+XCP_STATIC XcpDaq_ListLinkType XcpDaq_NextList[XCP_DAQ_SAMPLING_PLAN_SIZE];
 #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
 
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+XCP_STATIC XcpDaq_QueueIndexType XcpDaq_OverloadEventPending;
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+/*
+** Staging buffers for consistent sampling, one per event channel (lists of an event are sampled one after another).
+** Application updates in progress / completed, see XcpDaq_UpdateBegin().
+*/
+XCP_STATIC uint8_t                    XcpDaq_SnapshotBuffers[XCP_DAQ_MAX_EVENT_CHANNEL][XCP_DAQ_SNAPSHOT_BUFFER_SIZE];
+XCP_STATIC XcpDaq_SnapshotCounterType XcpDaq_UpdatesActive;
+XCP_STATIC XcpDaq_SnapshotCounterType XcpDaq_UpdatesDone;
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+#if XCP_ENABLE_STIM == XCP_ON
+/* Pool for the STIM images (three per STIM list), assigned at compile time. */
+XCP_STATIC uint8_t                XcpDaq_StimBuffers[XCP_DAQ_STIM_BUFFER_SIZE];
+XCP_STATIC uint32_t               XcpDaq_StimBufferUsed = UINT32(0);
+XCP_STATIC XcpDaq_StimStateType   XcpDaq_StimStates[XCP_DAQ_SAMPLING_PLAN_SIZE];
+XCP_STATIC XcpDaq_ListIntegerType XcpDaq_StimListForPid[XCP_DAQ_STIM_PID_LIMIT]; /* STIM list receiving a PID. */
+#endif /* XCP_ENABLE_STIM */
+
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+XCP_STATIC XcpDaq_RoundTripType XcpDaq_RoundTrips[XCP_DAQ_MAX_EVENT_CHANNEL];
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+XCP_STATIC XcpDaq_EventRateStateType XcpDaq_EventRates[XCP_DAQ_MAX_EVENT_CHANNEL];
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
 /*
 **
 ** Global Variables.
 **
 */
 
+/*
+** Lost samples per DAQ list and per event channel, reset on (dis-)connect.
+** Plain RAM variables, so the master can read them (SHORT_UPLOAD) or even acquire them.
+*/
+uint32_t XcpDaq_ListLostSamples[XCP_DAQ_SAMPLING_PLAN_SIZE];
+uint32_t XcpDaq_EventLostSamples[XCP_DAQ_MAX_EVENT_CHANNEL];
+
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+/* Round-trip statistics of bypass events (type DAQ_STIM), reset on (dis-)connect. */
+XcpDaq_BypassStatisticsType XcpDaq_BypassStatistics[XCP_DAQ_MAX_EVENT_CHANNEL];
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+/* Event-to-transmit latencies, reset on (dis-)connect. */
+XcpDaq_LatencyHistogramType XcpDaq_EventLatencies[XCP_DAQ_MAX_EVENT_CHANNEL];
+XcpDaq_LatencyHistogramType XcpDaq_TransportLatencies;
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+
 /*
 **
 ** Global Functions.
@@ -163,9 +629,11 @@ Xcp_ReturnType XcpDaq_Free(void) {
     XcpDaq_ListCount   = (XCP_DAQ_ENTITY_TYPE)0;
     XcpDaq_OdtCount    = (XCP_DAQ_ENTITY_TYPE)0;
 
-    #if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
-    XcpUtl_MemSet(XcpDaq_ListForEvent, UINT8(0), UINT32(sizeof(XcpDaq_ListForEvent[0]) * UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)));
-    #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    XcpDaq_ResetEventChannels();
+    XcpDaq_ResetSamplingPlan();
+    #if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+    XcpUtl_ZeroMem(XcpDaq_PackedLists, sizeof(XcpDaq_PackedLists));
+    #endif /* XCP_DAQ_ENABLE_ODT_PACKING */
 
     if (XcpDaq_AllocValidateTransition(XCP_CALL_FREE_DAQ)) {
         XcpUtl_MemSet(
@@ -179,8 +647,9 @@ Xcp_ReturnType XcpDaq_Free(void) {
 }
 
 Xcp_ReturnType XcpDaq_Alloc(XcpDaq_ListIntegerType daqCount) {
-    XCP_DAQ_ENTITY_TYPE idx;
-    Xcp_ReturnType      result = ERR_SUCCESS;
+    XCP_DAQ_ENTITY_TYPE    idx;
+    XcpDaq_ListIntegerType listIdx = (XcpDaq_ListIntegerType)0;
+    Xcp_ReturnType         result  = ERR_SUCCESS;
 
     if (!XcpDaq_AllocValidateTransition(XCP_CALL_ALLOC_DAQ)) {
     #if XCP_DAQ_ENABLE_RESET_DYN_DAQ_CONFIG_ON_SEQUENCE_ERROR == XCP_ON
@@ -188,12 +657,22 @@ Xcp_ReturnType XcpDaq_Alloc(XcpDaq_ListIntegerType daqCount) {
     #endif /* XCP_DAQ_ENABLE_RESET_DYN_DAQ_CONFIG_ON_SEQUENCE_ERROR */
         result = ERR_SEQUENCE;
     } else {
-        if ((XcpDaq_EntityCount + daqCount) <= (XCP_DAQ_ENTITY_TYPE)XCP_DAQ_MAX_DYNAMIC_ENTITIES) {
+        if (((XcpDaq_EntityCount + daqCount) <= (XCP_DAQ_ENTITY_TYPE)XCP_DAQ_MAX_DYNAMIC_ENTITIES) &&
+            ((UINT32(XcpDaq_GetListCount()) + UINT32(daqCount)) <= UINT32(XCP_DAQ_SAMPLING_PLAN_SIZE))) {
             XcpDaq_AllocState = XCP_AFTER_ALLOC_DAQ;
             for (idx = XcpDaq_EntityCount; idx < (XcpDaq_EntityCount + daqCount); ++idx) {
                 XcpDaq_Entities[idx].kind                   = UINT8(XCP_ENTITY_DAQ_LIST);
                 XcpDaq_Entities[idx].entity.daqList.numOdts = (XcpDaq_ODTIntegerType)0;
             }
+            for (listIdx = XcpDaq_GetListCount(); listIdx < (XcpDaq_GetListCount() + daqCount); ++listIdx) {
+    #if XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON
+                XcpDaq_InitListState(
+                    &XcpDaq_DynamicListsState[listIdx], (XcpDaq_ODTIntegerType)(XcpDaq_PredefinedOdtCount + XcpDaq_OdtCount)
+                );
+    #else
+                XcpDaq_InitListState(&XcpDaq_DynamicListsState[listIdx], (XcpDaq_ODTIntegerType)XcpDaq_OdtCount);
+    #endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS */
+            }
             XcpDaq_ListCount += daqCount;
             XcpDaq_EntityCount += daqCount;
         } else {
@@ -222,6 +701,10 @@ Xcp_ReturnType XcpDaq_AllocOdt(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTI
                 XcpDaq_Entities[daqListNumber].entity.daqList.firstOdt = XcpDaq_EntityCount;
             }
             XcpDaq_Entities[daqListNumber].entity.daqList.numOdts += odtCount;
+            /* Absolute ODT numbers of all subsequent lists are shifted. */
+            for (idx = (XCP_DAQ_ENTITY_TYPE)(daqListNumber + 1); idx < (XCP_DAQ_ENTITY_TYPE)XcpDaq_GetListCount(); ++idx) {
+                XcpDaq_DynamicListsState[idx].firstPid += odtCount;
+            }
             XcpDaq_OdtCount += odtCount;
             XcpDaq_EntityCount += odtCount;
         } else {
@@ -287,24 +770,40 @@ void XcpDaq_Init(void) {
     XcpDaq_SetProcessorState(XCP_DAQ_STATE_STOPPED);
     XcpDaq_SetPointer(0, 0, 0);
 #if XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON
+    XcpDaq_PredefinedOdtCount = (XcpDaq_ODTIntegerType)0;
     for (idx = (XcpDaq_ListIntegerType)0; idx < XcpDaq_PredefinedListCount; ++idx) {
-        XcpDaq_PredefinedListsState[idx].mode = UINT8(0);
-    #if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
-        XcpDaq_PredefinedListsState[idx].prescaler = UINT8(1);
-        XcpDaq_PredefinedListsState[idx].counter   = UINT8(0);
-    #endif /* XCP_DAQ_ENABLE_PRESCALER */
+        XcpDaq_InitListState(&XcpDaq_PredefinedListsState[idx], XcpDaq_PredefinedOdtCount);
+        XcpDaq_PredefinedOdtCount += XcpDaq_PredefinedLists[idx].numOdts;
     }
 #endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS */
 
-    /* Always reset the event-to-list mapping on init if single mapping is used */
-#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
-    XcpUtl_MemSet(XcpDaq_ListForEvent, UINT8(0), UINT32(sizeof(XcpDaq_ListForEvent[0]) * UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)));
-#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    /* Always reset the event-to-list mapping on init. */
+    XcpDaq_ResetEventChannels();
+    XcpUtl_ZeroMem(XcpDaq_ListLostSamples, sizeof(XcpDaq_ListLostSamples));
+    XcpUtl_ZeroMem(XcpDaq_EventLostSamples, sizeof(XcpDaq_EventLostSamples));
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    XcpUtl_ZeroMem(XcpDaq_BypassStatistics, sizeof(XcpDaq_BypassStatistics));
+    XcpUtl_ZeroMem(XcpDaq_RoundTrips, sizeof(XcpDaq_RoundTrips));
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+    XcpUtl_ZeroMem(XcpDaq_EventRates, sizeof(XcpDaq_EventRates));
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    XcpUtl_ZeroMem(XcpDaq_EventLatencies, sizeof(XcpDaq_EventLatencies));
+    XcpUtl_ZeroMem(&XcpDaq_TransportLatencies, sizeof(XcpDaq_TransportLatencies));
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+    XcpUtl_ZeroMem(XcpDaq_PackedLists, sizeof(XcpDaq_PackedLists));
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+    XcpDaq_QueueStore(XcpDaq_OverloadEventPending, 0U);
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
 
 #if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
     XcpDaq_AllocState = XCP_ALLOC_IDLE;
     (void)XcpDaq_Free();
 #endif /* XCP_DAQ_ENABLE_DYNAMIC_LISTS */
+    XcpDaq_ResetSamplingPlan();
 
 #if XCP_DAQ_ENABLE_QUEUING == XCP_ON
     XcpDaq_QueueInit();
@@ -416,26 +915,17 @@ XcpDaq_ListConfigurationType const *XcpDaq_GetListConfiguration(XcpDaq_ListInteg
 }
 
 XcpDaq_ListStateType *XcpDaq_GetListState(XcpDaq_ListIntegerType daqListNumber) {
-#if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
-
-#endif /* XCP_DAQ_ENABLE_DYNAMIC_LISTS */
-
     /* printf("XcpDaq_GetListState() number: %u\n", daqListNumber); */
 #if (XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON) && (XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_OFF)
     /* Dynamic DAQs only */
-    return &XcpDaq_ListState;
-
+    return &XcpDaq_DynamicListsState[daqListNumber];
 #elif (XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_OFF) && (XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON)
     /* Predefined DAQs only */
     return &XcpDaq_PredefinedListsState[daqListNumber];
 #elif (XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON) && (XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON)
     /* Dynamic and predefined DAQs */
     if (daqListNumber >= XcpDaq_PredefinedListCount) {
-        XcpDaq_DynamicListType *dl = &XcpDaq_Entities[daqListNumber].entity.daqList;
-
-        XcpDaq_ListState.mode = dl->mode;
-
-        return &XcpDaq_ListState;
+        return &XcpDaq_DynamicListsState[daqListNumber];
     } else {
         return &XcpDaq_PredefinedListsState[daqListNumber];
     }
@@ -447,6 +937,7 @@ void XcpDaq_SetListMode(
 ) {
     XcpDaq_ListStateType *entry = XcpDaq_GetListState(daqListNumber);
 
+    entry->priority = priority; /* Required to order event channel chains. */
     XcpDaq_AddEventChannel(daqListNumber, eventChannelNumber);
     entry->mode = XcpUtl_SetResetBit8(entry->mode, mode, XCP_DAQ_LIST_MODE_TIMESTAMP);
     entry->mode = XcpUtl_SetResetBit8(entry->mode, mode, XCP_DAQ_LIST_MODE_ALTERNATING);
@@ -488,7 +979,7 @@ void XcpDaq_WriteEntry(uint8_t bitOffset, uint8_t elemSize, uint8_t adddrExt, Xc
         return;
     }
 
-#if XCP_DAQ_BIT_OFFSET_SUPPORTED == XCP_ON
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
     entry->bitOffset = bitOffset;
 #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
     entry->length      = elemSize;
@@ -528,7 +1019,7 @@ void XcpDaq_ReadEntry(uint8_t *bitOffset, uint8_t *elemSize, uint8_t *adddrExt,
         return;
     }
 
-#if XCP_DAQ_BIT_OFFSET_SUPPORTED == XCP_ON
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
     *bitOffset = entry->bitOffset;
 #else
     *bitOffset = 0;
@@ -632,6 +1123,83 @@ bool XcpDaq_ValidateOdtEntry(
     return result;
 }
 
+/** @brief Checks if an ODT entry of the given size can be written at the DAQ pointer.
+ *
+ *  The ODT incl. identification field (and timestamp, if the list mode asks for it) must still
+ *  fit into a DTO, so oversized ODTs are rejected at allocation time. Switching timestamps on
+ *  later is checked by XcpDaq_ValidateListSize().
+ */
+bool XcpDaq_ValidateEntrySize(uint8_t elemSize) {
+    Xcp_StateType const        *Xcp_State = XCP_NULL;
+    XcpDaq_ODTEntryType const  *entry     = XCP_NULL;
+    XcpDaq_ODTEntryIntegerType  odtEntry  = 0;
+    XcpDaq_ODTIntegerType       dto       = 0;
+    uint32_t                    length    = UINT32(0);
+    uint8_t                     mode      = UINT8(0);
+
+    Xcp_State = Xcp_GetState();
+    if (XcpDaq_GetOdtEntry(Xcp_State->daqPointer.daqList, Xcp_State->daqPointer.odt, Xcp_State->daqPointer.odtEntry) ==
+        XCP_NULL) {
+        return (bool)XCP_TRUE; /* Invalid pointer, nothing gets written. */
+    }
+    dto  = Xcp_State->daqPointer.odt;
+    mode = XcpDaq_GetListState(Xcp_State->daqPointer.daqList)->mode;
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+    if ((Xcp_State->daqPointer.daqList < (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) &&
+        XcpDaq_PackedLists[Xcp_State->daqPointer.daqList]) {
+        /* Entries of packed lists spill over into the next DTO, only the entry itself has to fit. */
+        return (bool)((UINT32(XcpDaq_DtoHeaderLength(mode, 0)) + UINT32(elemSize)) <= UINT32(XCP_MAX_DTO));
+    }
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+    length = UINT32(XcpDaq_DtoHeaderLength(mode, dto)) + UINT32(elemSize);
+    for (odtEntry = (XcpDaq_ODTEntryIntegerType)0; odtEntry < Xcp_State->daqPointer.odtEntry; ++odtEntry) {
+        entry = XcpDaq_GetOdtEntry(Xcp_State->daqPointer.daqList, Xcp_State->daqPointer.odt, odtEntry);
+        length += UINT32(entry->length);
+    }
+    return (bool)(length <= UINT32(XCP_MAX_DTO));
+}
+
+/** @brief Checks if all ODTs of a DAQ list fit into DTOs, given a list mode.
+ *
+ *  @param daqListNumber    DAQ list.
+ *  @param mode             List mode, only XCP_DAQ_LIST_MODE_TIMESTAMP is relevant.
+ *  @note  Called by SET_DAQ_LIST_MODE (timestamps may be switched on after allocation) and START_STOP_DAQ_LIST.
+ */
+bool XcpDaq_ValidateListSize(XcpDaq_ListIntegerType daqListNumber, uint8_t mode) {
+    XcpDaq_ListConfigurationType const *listConf = XcpDaq_GetListConfiguration(daqListNumber);
+    XcpDaq_ODTType const               *odt      = XCP_NULL;
+    XcpDaq_ODTEntryType const          *entry    = XCP_NULL;
+    XcpDaq_ODTIntegerType               odtIdx   = 0;
+    XcpDaq_ODTEntryIntegerType          odtEntry = 0;
+    uint32_t                            length   = UINT32(0);
+    uint32_t                            largest  = UINT32(0);
+
+    if (listConf == XCP_NULL) {
+        return (bool)XCP_TRUE;
+    }
+    for (odtIdx = (XcpDaq_ODTIntegerType)0; odtIdx < listConf->numOdts; ++odtIdx) {
+        odt = XcpDaq_GetOdt(daqListNumber, odtIdx);
+        if (odt == XCP_NULL) {
+            continue;
+        }
+        length = UINT32(XcpDaq_DtoHeaderLength(mode, odtIdx));
+        for (odtEntry = (XcpDaq_ODTEntryIntegerType)0; odtEntry < odt->numOdtEntries; ++odtEntry) {
+            entry   = XcpDaq_GetOdtEntry(daqListNumber, odtIdx, odtEntry);
+            length += UINT32(entry->length);
+            largest = XCP_MAX(largest, UINT32(entry->length));
+        }
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+        if ((daqListNumber < (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) && XcpDaq_PackedLists[daqListNumber]) {
+            continue; /* Only the entries themselves have to fit, see below. */
+        }
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+        if (length > UINT32(XCP_MAX_DTO)) {
+            return (bool)XCP_FALSE;
+        }
+    }
+    return (bool)((UINT32(XcpDaq_DtoHeaderLength(mode, 0)) + largest) <= UINT32(XCP_MAX_DTO));
+}
+
 XcpDaq_EventType const *XcpDaq_GetEventConfiguration(uint16_t eventChannelNumber) {
     if (eventChannelNumber >= UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
         return (XcpDaq_EventType const *)XCP_NULL;
@@ -639,110 +1207,237 @@ XcpDaq_EventType const *XcpDaq_GetEventConfiguration(uint16_t eventChannelNumber
     return &XcpDaq_Events[eventChannelNumber];
 }
 
+/** @brief Assigns a DAQ list to an event channel, replacing its previous assignment.
+ *
+ *  @note   Event channel chains are only edited while the DAQ processor is stopped (SET_DAQ_LIST_MODE
+ *          answers ERR_DAQ_ACTIVE otherwise); a trigger that is still walking a chain after STOP
+ *          sees either the old or the new link of each list, i.e. a well-formed chain.
+ */
 void XcpDaq_AddEventChannel(XcpDaq_ListIntegerType daqListNumber, uint16_t eventChannelNumber) {
+    XcpDaq_ListStateType *state = XcpDaq_GetListState(daqListNumber);
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+    XcpDaq_ListLinkType   *link  = XCP_NULL;
+    XcpDaq_ListIntegerType other = (XcpDaq_ListIntegerType)0;
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+
+    if ((eventChannelNumber >= UINT16(XCP_DAQ_MAX_EVENT_CHANNEL)) ||
+        (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE)) {
+        return;
+    }
+    if (Xcp_GetState()->daqProcessor.state == XCP_DAQ_STATE_RUNNING) {
+        return;
+    }
+    XcpDaq_RemoveEventChannel(daqListNumber);
 #if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
-    if (eventChannelNumber < UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
-        XcpDaq_ListForEvent[eventChannelNumber] = daqListNumber;
+    if (XcpDaq_LinkLoad(XcpDaq_ListForEvent[eventChannelNumber]) != XCP_DAQ_NO_LIST) {
+        /* Replaces the previously assigned list. */
+        XcpDaq_RemoveEventChannel(XcpDaq_LinkLoad(XcpDaq_ListForEvent[eventChannelNumber]));
     }
+    XcpDaq_LinkStore(XcpDaq_ListForEvent[eventChannelNumber], daqListNumber);
+#else
+    /* Insert ordered by descending priority, lower list numbers first on ties. */
+    link = &XcpDaq_ListForEvent[eventChannelNumber];
+    while ((other = XcpDaq_LinkLoad(*link)) != XCP_DAQ_NO_LIST) {
+        if ((XcpDaq_GetListState(other)->priority < state->priority) ||
+            ((XcpDaq_GetListState(other)->priority == state->priority) && (other > daqListNumber))) {
+            break;
+        }
+        link = &XcpDaq_NextList[other];
+    }
+    /* Complete before it becomes reachable. */
+    XcpDaq_LinkStore(XcpDaq_NextList[daqListNumber], other);
+    XcpDaq_LinkStore(*link, daqListNumber);
 #endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    state->eventChannel = eventChannelNumber;
 }
 
 /** @brief Triggers acquisition and transmission of DAQ lists.
  *
  *  @param eventChannelNumber   Number of event to trigger.
+ *  @note   Event channels switched to asynchronous sampling (XcpDaq_SetAsyncSampling()) are only
+ *          recorded here and sampled later by XcpDaq_ProcessEvents().
  */
 void XcpDaq_TriggerEvent(uint8_t eventChannelNumber) {
-    Xcp_StateType const       *state         = XCP_NULL;
-    XcpDaq_ListIntegerType     daqListNumber = 0;
-    XcpDaq_ODTIntegerType      odtIdx        = 0;
-    XcpDaq_ODTIntegerType      pid           = 0;
-    XcpDaq_ODTEntryIntegerType odtEntryIdx   = 0;
-    XcpDaq_ODTType const      *odt           = XCP_NULL;
-    // XcpDaq_ODTEntryType                *entry             = XCP_NULL;
-    XcpDaq_ODTEntryType                 entry;
-    XcpDaq_ListConfigurationType const *listConf          = XCP_NULL;
-    XcpDaq_ListStateType               *listState         = XCP_NULL;
-    uint16_t                            offset            = UINT16(0);
-    uint8_t                             data[XCP_MAX_DTO] = { 0 };
-#if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
-    uint32_t timestamp        = UINT32(0);
-    bool     insert_timestamp = XCP_FALSE;
+    Xcp_StateType const *state     = XCP_NULL;
+    XcpDaq_TimestampType timestamp = XcpDaq_EventTimestamp();
 
-    timestamp = XcpHw_GetTimerCounter();
-#endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
     state = Xcp_GetState();
     if (state->daqProcessor.state != XCP_DAQ_STATE_RUNNING) {
         return;
     }
-    if (eventChannelNumber >= UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
-        return;
+#if XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_OFF
+    if (XcpDaq_DispatchEvent(eventChannelNumber, timestamp)) {
+        XcpDaq_TransmitDtos();
     }
+#else
+    (void)XcpDaq_DispatchEvent(eventChannelNumber, timestamp);
+#endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+}
 
-#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
-    daqListNumber = XcpDaq_ListForEvent[eventChannelNumber];
-#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+/** @brief Triggers several event channels at once, e.g. all channels of a scheduler tick.
+ *
+ *  Same as calling XcpDaq_TriggerEvent() for each channel, but all occurrences share one timestamp
+ *  and the DTOs of all channels are flushed together.
+ *
+ *  @param eventChannelNumbers  Event channels, in sampling order.
+ *  @param count                Number of event channels.
+ */
+void XcpDaq_TriggerEvents(uint8_t const *eventChannelNumbers, uint8_t count) {
+    Xcp_StateType const *state     = XCP_NULL;
+    XcpDaq_TimestampType timestamp = XcpDaq_EventTimestamp();
+    uint8_t              idx       = UINT8(0);
+    bool                 sampled   = (bool)XCP_FALSE;
 
-    /* Ensure DAQ list is started and handle prescaler if configured */
-    listState = XcpDaq_GetListState(daqListNumber);
-    if ((listState == XCP_NULL) || ((listState->mode & XCP_DAQ_LIST_MODE_STARTED) != XCP_DAQ_LIST_MODE_STARTED)) {
+    state = Xcp_GetState();
+    if (state->daqProcessor.state != XCP_DAQ_STATE_RUNNING) {
         return;
     }
-#if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
-    if (listState->prescaler > UINT8(1)) {
-        listState->counter++;
-        if (listState->counter < listState->prescaler) {
-            return; /* Not yet time to send */
+    for (idx = UINT8(0); idx < count; ++idx) {
+        if (XcpDaq_DispatchEvent(eventChannelNumbers[idx], timestamp)) {
+            sampled = (bool)XCP_TRUE;
         }
-        listState->counter = UINT8(0);
-    }
-#endif /* XCP_DAQ_ENABLE_PRESCALER */
-
-    if (!XcpDaq_GetFirstPid(daqListNumber, &pid)) {
-        return;
     }
-    listConf = XcpDaq_GetListConfiguration(daqListNumber);
-#if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
-    if ((listState->mode & XCP_DAQ_LIST_MODE_TIMESTAMP) == XCP_DAQ_LIST_MODE_TIMESTAMP) {
-        insert_timestamp = XCP_TRUE;
+#if XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_OFF
+    if (sampled) {
+        XcpDaq_TransmitDtos();
     }
-#endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
-    for (odtIdx = (XcpDaq_ODTIntegerType)0; odtIdx < listConf->numOdts; ++odtIdx) {
-        offset = UINT16(0);
-        odt    = XcpDaq_GetOdt(daqListNumber, odtIdx);
+#else
+    XCP_UNREFERENCED_PARAMETER(sampled);
+#endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+}
 
-#if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-        /* PID_OFF: Identification field (PID) is omitted. */
+/** @brief Time of an event occurrence, only read if someone needs it.
+ */
+XCP_STATIC XcpDaq_TimestampType XcpDaq_EventTimestamp(void) {
+#if (XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON) || (XCP_DAQ_ENABLE_BYPASS == XCP_ON) ||                                         \
+    (XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON) || (XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON)
+    #if XCP_DAQ_TIMESTAMP_SIZE == XCP_DAQ_TIMESTAMP_SIZE_8
+    return XcpHw_GetTimerCounter64();
+    #else
+    return XcpHw_GetTimerCounter();
+    #endif /* XCP_DAQ_TIMESTAMP_SIZE */
 #else
-        data[0] = pid; /* Absolute ODT number. */
-        offset += UINT16(1);
-#endif
+    return (XcpDaq_TimestampType)0;
+#endif /* XCP_DAQ_ENABLE_TIMESTAMPING, XCP_DAQ_ENABLE_BYPASS, XCP_DAQ_ENABLE_EVENT_RATE_LIMITS, XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+}
 
-#if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
-        if ((odtIdx == (XcpDaq_ODTIntegerType)0) && (insert_timestamp == XCP_TRUE)) {  // TODO: check for sufficient space.
-            XcpDaq_CopyMemory(&data[offset], (void *)&timestamp, XCP_DAQ_TIMESTAMP_SIZE);
-            offset += XCP_DAQ_TIMESTAMP_SIZE;
+/** @brief Samples an event occurrence or, if the channel is sampled asynchronously, hands it to the DAQ worker.
+ *
+ *  @return XCP_TRUE if the occurrence was sampled right here, i.e. there may be DTOs to transmit.
+ *  @note   DAQ processor must be running; transmission is left to the caller.
+ */
+XCP_STATIC bool XcpDaq_DispatchEvent(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp) {
+    if (eventChannelNumber >= UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
+        return (bool)XCP_FALSE;
+    }
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+    if (!XcpDaq_EventDue(eventChannelNumber, (uint32_t)timestamp)) {
+        return (bool)XCP_FALSE;
+    }
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    if (atomic_load_explicit(&XcpDaq_AsyncEvents[eventChannelNumber], memory_order_relaxed)) {
+        /* Sampling is left to the DAQ worker, the timestamp still reflects the occurrence. */
+        if (!XcpDaq_EventRingPush(eventChannelNumber, timestamp)) {
+            XcpDaq_EventLostSamples[eventChannelNumber]++;
+        } else if (XcpDaq_WorkerCallout != (XcpDaq_WorkerCalloutType)XCP_NULL) {
+            XcpDaq_WorkerCallout();
         }
-#endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
-        for (odtEntryIdx = (XcpDaq_ODTEntryIntegerType)0; odtEntryIdx < odt->numOdtEntries; ++odtEntryIdx) {
-            entry = XcpDaq_GetOdtEntryValues(daqListNumber, odtIdx, odtEntryIdx);
-            // XCP_ASSERT_LE(entry.length, (unsigned int)(XCP_MAX_DTO - offset));
-            if (entry.length > (unsigned int)(XCP_MAX_DTO - offset)) {
-                return;  // Error: Out of memory.
-            }
+        return (bool)XCP_FALSE;
+    }
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+    XcpDaq_ProcessEvent(eventChannelNumber, timestamp);
+    return (bool)XCP_TRUE;
+}
 
-            XcpDaq_CopyMemory(&data[offset], (void *)entry.mta.address, entry.length);
-            offset += entry.length;
+/** @brief Samples (resp. stimulates) the DAQ lists of an event occurrence, without transmitting them.
+ */
+XCP_STATIC void XcpDaq_ProcessEvent(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp) {
+    XcpDaq_ListIntegerType daqListNumber = 0;
+    XcpDaq_ListStateType  *listState     = XCP_NULL;
+    bool                   complete      = (bool)XCP_TRUE;
+
+    daqListNumber = XcpDaq_LinkLoad(XcpDaq_ListForEvent[eventChannelNumber]);
+    while (daqListNumber != XCP_DAQ_NO_LIST) {
+        listState = XcpDaq_GetListState(daqListNumber);
+#if XCP_ENABLE_STIM == XCP_ON
+        if ((listState->mode & XCP_DAQ_LIST_MODE_DIRECTION) == XCP_DAQ_LIST_MODE_DIRECTION) {
+            XcpDaq_ApplyStim(daqListNumber, listState);
+        } else
+#endif /* XCP_ENABLE_STIM */
+        {
+            if (!XcpDaq_SampleList(daqListNumber, listState, timestamp)) {
+                complete = (bool)XCP_FALSE;
+            }
         }
-#if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-        XcpDaq_QueueEnqueue(offset, data, (uint32_t)XCP_DAQ_CAN_ID_BASE + (uint32_t)pid);
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+        daqListNumber = XcpDaq_LinkLoad(XcpDaq_NextList[daqListNumber]);
 #else
-        XcpDaq_QueueEnqueue(offset, data);
-#endif
-        pid++;
-        //        XcpUtl_Hexdump(data, offset);
+        daqListNumber = XCP_DAQ_NO_LIST;
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    }
+    if (!complete) {
+        XcpDaq_EventLostSamples[eventChannelNumber]++;
+    }
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    XcpDaq_CloseRoundTrip(eventChannelNumber, (uint32_t)timestamp);
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+}
+
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+/** @brief Selects where the DAQ lists of an event channel are sampled.
+ *
+ *  Synchronous sampling (the default) happens inside XcpDaq_TriggerEvent(), i.e. the data is consistent
+ *  with the occurrence, but the application pays for it. Asynchronous sampling leaves only a ring entry
+ *  behind and the DAQ worker samples later, i.e. the data may be up to one worker cycle younger than
+ *  the (unchanged) timestamp.
+ *
+ *  @param eventChannelNumber   Event channel.
+ *  @param async                Sample by the DAQ worker.
+ *  @note   May be changed while DAQ is running; the worker and the application are both producers of the
+ *          DTO queue, hence XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS.
+ */
+void XcpDaq_SetAsyncSampling(uint8_t eventChannelNumber, bool async) {
+    if (eventChannelNumber >= UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
+        return;
+    }
+    atomic_store_explicit(&XcpDaq_AsyncEvents[eventChannelNumber], async, memory_order_relaxed);
+}
+
+/** @brief Installs the function that wakes up an idle DAQ worker.
+ *
+ *  Called by XcpDaq_TriggerEvent() after each occurrence recorded for the worker, i.e. it must be cheap
+ *  while the worker is busy. XCP_NULL (the default) for workers that poll.
+ *
+ *  @param callout  Wake-up function.
+ */
+void XcpDaq_SetWorkerCallout(XcpDaq_WorkerCalloutType callout) {
+    XcpDaq_WorkerCallout = callout;
+}
+
+/** @brief Body of the DAQ worker: samples all event occurrences recorded so far.
+ *
+ *  @return XCP_TRUE if there was anything to do.
+ *  @note   Consumer side of the event ring, must not be called from more than one thread.
+ */
+bool XcpDaq_ProcessEvents(void) {
+    Xcp_StateType const *state        = XCP_NULL;
+    XcpDaq_TimestampType timestamp    = (XcpDaq_TimestampType)0;
+    uint8_t              eventChannel = UINT8(0);
+    bool                 processed    = (bool)XCP_FALSE;
+
+    state = Xcp_GetState();
+    while (XcpDaq_EventRingPop(&eventChannel, &timestamp)) {
+        /* Occurrences recorded before a STOP are dropped. */
+        if (state->daqProcessor.state == XCP_DAQ_STATE_RUNNING) {
+            XcpDaq_ProcessEvent(eventChannel, timestamp);
+        }
+        processed = (bool)XCP_TRUE;
     }
-    XcpDaq_TransmitDtos();
+    /* DTOs are sent by Xcp_MainFunction() (deferred transmission). */
+    return processed;
 }
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 
 /** @brief Copies bytes from a source memory area to a destination memory area,
  *   where both areas may not overlap.
@@ -764,10 +1459,20 @@ void XcpDaq_GetProperties(uint8_t *properties) {
     *properties |= XCP_DAQ_PROP_TIMESTAMP_SUPPORTED;
 #endif /*XCP_DAQ_ENABLE_TIMESTAMPING */
 
+#if (XCP_ENABLE_STIM == XCP_ON) && (XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON)
+    *properties |= XCP_DAQ_PROP_BIT_STIM_SUPPORTED;
+#endif /* (XCP_ENABLE_STIM == XCP_ON) && (XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON) */
+
 #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
     *properties |= XCP_DAQ_PROP_PID_OFF_SUPPORTED;
 #endif /* (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN) */
 
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+    *properties |= XCP_DAQ_PROP_OVERLOAD_MSB;
+#elif XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+    *properties |= XCP_DAQ_PROP_OVERLOAD_EVENT;
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+
 #if (XCP_DAQ_CONFIG_TYPE == XCP_DAQ_CONFIG_TYPE_NONE) || (XCP_DAQ_CONFIG_TYPE == XCP_DAQ_CONFIG_TYPE_STATIC)
     *properties |= UINT8(XCP_DAQ_CONFIG_TYPE_STATIC);
 #elif XCP_DAQ_CONFIG_TYPE == XCP_DAQ_CONFIG_TYPE_DYNAMIC
@@ -793,11 +1498,22 @@ void XcpDaq_StopSelectedLists(void) {
 }
 
 void XcpDaq_StopAllLists(void) {
-    XcpDaq_StartStopLists(DAQ_LIST_TRANSITION_STOP);
+    XcpDaq_ListIntegerType idx = 0;
+
+    /* Not only the selected ones -- the sampling plan starts over only once no list is running. */
+    for (idx = (XcpDaq_ListIntegerType)0; idx < XcpDaq_GetListCount(); ++idx) {
+        XcpDaq_GetListState(idx)->mode &= UINT8(~(XCP_DAQ_LIST_MODE_STARTED | XCP_DAQ_LIST_MODE_SELECTED));
+    }
 }
 
-void XcpDaq_StartStopSingleList(XcpDaq_ListIntegerType daqListNumber, uint8_t mode) {
+/** @brief Starts, stops, or selects a DAQ list.
+ *
+ *  @return ERR_DAQ_CONFIG or ERR_MEMORY_OVERFLOW if the sampling plan of the list can't be compiled,
+ *          the list isn't started then.
+ */
+Xcp_ReturnType XcpDaq_StartStopSingleList(XcpDaq_ListIntegerType daqListNumber, uint8_t mode) {
     XcpDaq_ListStateType *list_state = XCP_NULL;
+    Xcp_ReturnType        result     = ERR_SUCCESS;
 
     list_state = XcpDaq_GetListState(daqListNumber);
 
@@ -806,15 +1522,41 @@ void XcpDaq_StartStopSingleList(XcpDaq_ListIntegerType daqListNumber, uint8_t mo
         list_state->mode &= UINT8(~XCP_DAQ_LIST_MODE_STARTED);
     } else if (mode == UINT8(1)) {
         /* Start DAQ list immediately */
-        list_state->mode |= XCP_DAQ_LIST_MODE_STARTED;
+        result = XcpDaq_CompileSamplingPlan(daqListNumber);
+        if (result == ERR_SUCCESS) {
+            list_state->mode |= XCP_DAQ_LIST_MODE_STARTED;
+        }
     } else if (mode == UINT8(2)) {
         /* Select DAQ list for synchronized start/stop */
         list_state->mode |= XCP_DAQ_LIST_MODE_SELECTED;
     }
+    return result;
 }
 
-void XcpDaq_StartStopSynch(uint8_t mode) {
+/** @brief Starts or stops DAQ lists synchronously.
+ *
+ *  @return ERR_DAQ_CONFIG or ERR_MEMORY_OVERFLOW if the sampling plan of a selected list can't be compiled,
+ *          none of the selected lists is started then.
+ */
+Xcp_ReturnType XcpDaq_StartStopSynch(uint8_t mode) {
+    Xcp_ReturnType result = ERR_SUCCESS;
+
     if (mode == XCP_DAQ_LISTS_START_SELECTED) {
+        result = XcpDaq_CompileSamplingPlan(XCP_DAQ_NO_LIST);
+        if (result != ERR_SUCCESS) {
+            return result;
+        }
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+        if (Xcp_GetState()->daqProcessor.state != XCP_DAQ_STATE_RUNNING) {
+            /* Events are idle, round trips start over. */
+            XcpUtl_ZeroMem(XcpDaq_RoundTrips, sizeof(XcpDaq_RoundTrips));
+        }
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+        if (Xcp_GetState()->daqProcessor.state != XCP_DAQ_STATE_RUNNING) {
+            XcpUtl_ZeroMem(XcpDaq_EventRates, sizeof(XcpDaq_EventRates));
+        }
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
         XcpDaq_StartSelectedLists();
         XcpDaq_SetProcessorState(XCP_DAQ_STATE_RUNNING);
     } else if (mode == XCP_DAQ_LISTS_STOP_ALL) {
@@ -823,27 +1565,128 @@ void XcpDaq_StartStopSynch(uint8_t mode) {
     } else if (mode == XCP_DAQ_LISTS_STOP_SELECTED) {
         XcpDaq_StopSelectedLists();
     }
+    return result;
 }
 
 void XcpDaq_TransmitDtos(void) {
-    uint16_t len     = 0UL;
-    uint8_t *dataOut = Xcp_GetDtoOutPtr();
+    uint16_t len = 0UL;
+    uint8_t *dto = XCP_NULL;
 #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
     uint32_t can_id = 0;
 #endif
-
-    while (!XcpDaq_QueueEmpty()) {
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    XcpDaq_OdtType const *slot       = XCP_NULL;
+    uint32_t              dequeuedAt = UINT32(0);
+    uint32_t              sentAt     = UINT32(0);
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+    XcpTl_FrameType frames[XCP_DAQ_TRANSMIT_BATCH_SIZE];
+    uint16_t        count = UINT16(0);
+    uint16_t        idx   = UINT16(0);
+#endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+    bool ready = (bool)XCP_FALSE;
+
+    /*
+    ** DTOs are framed and sent directly from their queue slots, by one consumer at a time.
+    ** Nobody else may release or discard the slots in transit, so no lock is held while
+    ** the transport layer sends; neither producers nor Xcp_GetState() wait for it.
+    */
+    do {
+        if (!XcpDaq_QueueClaim()) {
+            return; /* Someone else is consuming, and will see our DTOs, too. */
+        }
+        for (;;) {
+            ready = XcpDaq_QueueDiscard();
+            if (!ready) {
+                break; /* Producers are still busy with the old queue contents, retried next time. */
+            }
 #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-        if (XcpDaq_QueueDequeue(&len, dataOut, &can_id)) {
+            dto = XcpDaq_QueuePeek(&len, &can_id);
             Xcp_DtoCanId = can_id;
 #else
-        if (XcpDaq_QueueDequeue(&len, dataOut)) {
+            dto = XcpDaq_QueuePeek(&len);
 #endif
-            Xcp_SetDtoOutLen(len);
-            Xcp_SendDto();
+            if (dto == XCP_NULL) {
+                break;
+            }
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+            dequeuedAt = XcpHw_GetTimerCounter();
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+            /*
+            ** Consecutive DTOs of the peeked priority queue are framed in order (transport layer counter)
+            ** and go out with a single XcpTl_SendBatch(); higher priority DTOs wait for the next batch.
+            */
+            count = UINT16(0);
+            while (dto != XCP_NULL) {
+                frames[count].data = dto - XCP_TRANSPORT_LAYER_BUFFER_OFFSET;
+                frames[count].len  = Xcp_FrameDto(dto, len);
+                ++count;
+                if (count == UINT16(XCP_DAQ_TRANSMIT_BATCH_SIZE)) {
+                    break;
+                }
+                dto = XcpDaq_QueuePeekAhead(count, &len);
+            }
+            XcpTl_SendBatch(frames, count);
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+            sentAt = XcpHw_GetTimerCounter();
+            /* One sample per batch, the histograms are updated after the send path has been timed. */
+            XcpDaq_RecordLatency(&XcpDaq_TransportLatencies, sentAt - dequeuedAt);
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+            for (idx = UINT16(0); idx < count; ++idx) {
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+                slot = XcpDaq_QueueSlotFromDto(frames[idx].data + XCP_TRANSPORT_LAYER_BUFFER_OFFSET);
+                if (slot->event < UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
+                    XcpDaq_RecordLatency(&XcpDaq_EventLatencies[slot->event], dequeuedAt - slot->sampledAt);
+                }
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+                XcpDaq_QueueRelease();
+            }
+#else
+            Xcp_SendDtoBuffer(dto, len);
+    #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+            sentAt = XcpHw_GetTimerCounter();
+            XcpDaq_RecordLatency(&XcpDaq_TransportLatencies, sentAt - dequeuedAt);
+            slot = XcpDaq_QueueSlotFromDto(dto);
+            if (slot->event < UINT8(XCP_DAQ_MAX_EVENT_CHANNEL)) {
+                XcpDaq_RecordLatency(&XcpDaq_EventLatencies[slot->event], dequeuedAt - slot->sampledAt);
+            }
+    #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+            XcpDaq_QueueRelease();
+#endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
         }
+        XcpDaq_QueueUnclaim();
+        /* DTOs committed (or a discard requested) while we were about to let go. */
+    } while (ready && XcpDaq_QueuePending());
+#if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+    /* The transport layer may hold back DTOs (e.g. packing), give it a chance to send them. */
+    XcpTl_SendPending();
+#endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+    /* Reported after the DTOs sampled before the overrun. */
+    if (XcpDaq_QueueLoad(XcpDaq_OverloadEventPending) != 0U) {
+        XcpDaq_QueueStore(XcpDaq_OverloadEventPending, 0U);
+        XcpEvent_DaqOverload();
+    }
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+}
+
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+/** @brief Counts a latency in its log2 bucket.
+ *
+ *  @param ticks    Timer difference, wrap-arounds of XcpHw_GetTimerCounter() are masked off.
+ */
+XCP_STATIC void XcpDaq_RecordLatency(XcpDaq_LatencyHistogramType *histogram, uint32_t ticks) {
+    uint8_t bucket = UINT8(0);
+
+    ticks &= XCP_DAQ_TIMER_MASK;
+    while ((ticks != UINT32(0)) && (bucket < UINT8(XCP_DAQ_LATENCY_BUCKETS - 1))) {
+        ticks >>= 1;
+        bucket++;
     }
+    histogram->buckets[bucket]++;
 }
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
 
 /*
 ** Local Functions.
@@ -903,26 +1746,1093 @@ XCP_STATIC void XcpDaq_StartStopLists(XcpDaq_ListTransitionType transition) {
     }
 }
 
-bool XcpDaq_GetFirstPid(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType *firstPID) {
-    XcpDaq_ListIntegerType              listIdx = 0;
-    XcpDaq_ListConfigurationType const *daqList = XCP_NULL;
-    bool                                result  = (bool)XCP_TRUE;
-    XcpDaq_ODTIntegerType               tmp     = (XcpDaq_ODTIntegerType)0;
+XCP_STATIC void XcpDaq_InitListState(XcpDaq_ListStateType *state, XcpDaq_ODTIntegerType firstPid) {
+    state->mode         = UINT8(0);
+    state->priority     = UINT8(0);
+    state->firstPid     = firstPid;
+    state->eventChannel = XCP_DAQ_NO_EVENT_CHANNEL;
+#if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
+    state->prescaler = UINT8(1);
+    state->counter   = UINT8(0);
+#endif /* XCP_DAQ_ENABLE_PRESCALER */
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+    state->overload = (bool)XCP_FALSE;
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+}
 
-    if (daqListNumber > (XcpDaq_GetListCount() - UINT16(1))) {
-        result = (bool)XCP_FALSE;
-    } else {
-        for (listIdx = UINT16(0); listIdx < daqListNumber; ++listIdx) {
-            daqList = XcpDaq_GetListConfiguration(listIdx);
-            tmp += daqList->numOdts;
-        }
+XCP_STATIC void XcpDaq_ResetEventChannels(void) {
+    uint16_t idx = UINT16(0);
+#if (XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON) || (XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON)
+    XcpDaq_ListIntegerType listIdx = (XcpDaq_ListIntegerType)0;
+#endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS, XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+
+    for (idx = UINT16(0); idx < UINT16(XCP_DAQ_MAX_EVENT_CHANNEL); ++idx) {
+        XcpDaq_LinkStore(XcpDaq_ListForEvent[idx], XCP_DAQ_NO_LIST);
     }
-    *firstPID = tmp;
-    return result;
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+    for (listIdx = (XcpDaq_ListIntegerType)0; listIdx < (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE; ++listIdx) {
+        XcpDaq_LinkStore(XcpDaq_NextList[listIdx], XCP_DAQ_NO_LIST);
+    }
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+#if XCP_DAQ_ENABLE_PREDEFINED_LISTS == XCP_ON
+    for (listIdx = (XcpDaq_ListIntegerType)0; listIdx < XcpDaq_PredefinedListCount; ++listIdx) {
+        XcpDaq_PredefinedListsState[listIdx].eventChannel = XCP_DAQ_NO_EVENT_CHANNEL;
+    }
+#endif /* XCP_DAQ_ENABLE_PREDEFINED_LISTS */
 }
 
-/*
-**  Debugging / Testing interface.
+/** @brief Detaches a DAQ list from its event channel (if any).
+ */
+XCP_STATIC void XcpDaq_RemoveEventChannel(XcpDaq_ListIntegerType daqListNumber) {
+    XcpDaq_ListStateType *state = XcpDaq_GetListState(daqListNumber);
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_ON
+    XcpDaq_ListLinkType   *link    = XCP_NULL;
+    XcpDaq_ListIntegerType current = (XcpDaq_ListIntegerType)0;
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+
+    if (state->eventChannel == XCP_DAQ_NO_EVENT_CHANNEL) {
+        return;
+    }
+#if XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT == XCP_OFF
+    if (XcpDaq_LinkLoad(XcpDaq_ListForEvent[state->eventChannel]) == daqListNumber) {
+        XcpDaq_LinkStore(XcpDaq_ListForEvent[state->eventChannel], XCP_DAQ_NO_LIST);
+    }
+#else
+    link = &XcpDaq_ListForEvent[state->eventChannel];
+    while ((current = XcpDaq_LinkLoad(*link)) != XCP_DAQ_NO_LIST) {
+        if (current == daqListNumber) {
+            /* Own link is left alone, a trigger standing on this list still finds the rest of the chain. */
+            XcpDaq_LinkStore(*link, XcpDaq_LinkLoad(XcpDaq_NextList[daqListNumber]));
+            break;
+        }
+        link = &XcpDaq_NextList[current];
+    }
+#endif /* XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT */
+    state->eventChannel = XCP_DAQ_NO_EVENT_CHANNEL;
+}
+
+/** @brief Samples a started DAQ list according to its sampling plan and queues the resulting DTOs.
+ *
+ *  @return XCP_FALSE if ODTs were lost due to queue overload.
+ */
+XCP_STATIC bool XcpDaq_SampleList(
+    XcpDaq_ListIntegerType daqListNumber, XcpDaq_ListStateType *listState, XcpDaq_TimestampType timestamp
+) {
+    XcpDaq_ODTIntegerType       odtIdx            = 0;
+    XcpDaq_ODTIntegerType       pid               = 0;
+    uint16_t                    entryIdx          = UINT16(0);
+    XcpDaq_PlanListType const  *planList          = XCP_NULL;
+    XcpDaq_PlanOdtType const   *planOdt           = XCP_NULL;
+    XcpDaq_PlanEntryType const *planEntry         = XCP_NULL;
+    uint8_t                    *data              = XCP_NULL;
+    bool                        complete          = (bool)XCP_TRUE;
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    uint8_t const *snapshot = XCP_NULL;
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+    /* Ensure DAQ list is started and handle prescaler if configured */
+    if ((listState->mode & XCP_DAQ_LIST_MODE_STARTED) != XCP_DAQ_LIST_MODE_STARTED) {
+        return (bool)XCP_TRUE;
+    }
+#if XCP_DAQ_ENABLE_PRESCALER == XCP_ON
+    if (listState->prescaler > UINT8(1)) {
+        listState->counter++;
+        if (listState->counter < listState->prescaler) {
+            return (bool)XCP_TRUE; /* Not yet time to send */
+        }
+        listState->counter = UINT8(0);
+    }
+#endif /* XCP_DAQ_ENABLE_PRESCALER */
+
+    if (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) {
+        return (bool)XCP_TRUE;
+    }
+    planList = &XcpDaq_PlanLists[daqListNumber];
+    if (!planList->valid) {
+        return (bool)XCP_TRUE; /* List wasn't compiled at start time. */
+    }
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    if (planList->snapshotLength > UINT16(0)) {
+        /* Capture first, packetizing and queuing happen outside the consistency window. */
+        if (!XcpDaq_TakeSnapshot(planList, XcpDaq_SnapshotBuffers[listState->eventChannel])) {
+            /* Counted once, per DAQ list: no queue overload, nothing to report for the event channel. */
+            XcpDaq_ListLostSamples[daqListNumber]++;
+            return (bool)XCP_TRUE;
+        }
+        snapshot = XcpDaq_SnapshotBuffers[listState->eventChannel];
+    }
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+    pid     = planList->firstPid;
+    planOdt = &XcpDaq_PlanOdts[planList->firstOdt];
+    for (odtIdx = (XcpDaq_ODTIntegerType)0; odtIdx < planList->numOdts; ++odtIdx, ++planOdt, ++pid) {
+        /* ODTs are assembled in place, right in the next free queue slot. */
+#if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+        data = XcpDaq_QueueReserveForList(daqListNumber, planList->queue);
+#else
+        data = XcpDaq_QueueReserveLevel(planList->queue);
+#endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+        if (data == XCP_NULL) {
+            /* Queue overload, ODT is lost. */
+            complete = (bool)XCP_FALSE;
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+            listState->overload = (bool)XCP_TRUE;
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+            continue;
+        }
+#if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+        XcpDaq_QueueSlotFromDto(data)->sampledAt = (uint32_t)timestamp;
+        XcpDaq_QueueSlotFromDto(data)->event     = UINT8(listState->eventChannel);
+#endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+#if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+        /* PID_OFF: Identification field (PID) is omitted. */
+#else
+        data[0] = pid; /* Absolute ODT number. */
+#endif
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+        if (listState->overload) {
+            data[0] |= XCP_DAQ_OVERLOAD_PID_MSB;
+            listState->overload = (bool)XCP_FALSE;
+        }
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+
+#if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
+        if (planOdt->timestamp) {
+            XcpDaq_CopyMemory(&data[XCP_DAQ_PID_SIZE], (void *)&timestamp, XCP_DAQ_DTO_TIMESTAMP_SIZE);
+        }
+#else
+        XCP_UNREFERENCED_PARAMETER(timestamp);
+#endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+        if (snapshot != XCP_NULL) {
+            XcpDaq_CopyMemory(
+                &data[planOdt->dataOffset], &snapshot[planOdt->imageOffset], UINT32(planOdt->length - planOdt->dataOffset)
+            );
+        } else
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+        {
+            planEntry = &XcpDaq_PlanEntries[planOdt->firstEntry];
+            for (entryIdx = UINT16(0); entryIdx < planOdt->numEntries; ++entryIdx, ++planEntry) {
+                XcpDaq_CopyMemory(&data[planEntry->offset], (void const *)planEntry->src, planEntry->length);
+            }
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+            XcpDaq_SampleBits(planOdt, data, UINT16(0));
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+        }
+#if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+        XcpDaq_QueueCommit(data, planOdt->length, (uint32_t)XCP_DAQ_CAN_ID_BASE + (uint32_t)pid);
+#else
+        XcpDaq_QueueCommit(data, planOdt->length);
+#endif
+        //        XcpUtl_Hexdump(data, planOdt->length);
+    }
+    if (!complete) {
+        XcpDaq_ListLostSamples[daqListNumber]++;
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_EVENT
+        XcpDaq_QueueStore(XcpDaq_OverloadEventPending, 1U);
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+    }
+    return complete;
+}
+
+XCP_STATIC void XcpDaq_ResetSamplingPlan(void) {
+    XCP_DAQ_ENTER_CRITICAL();
+    XcpDaq_ClearSamplingPlan();
+    XCP_DAQ_LEAVE_CRITICAL();
+}
+
+XCP_STATIC void XcpDaq_ClearSamplingPlan(void) {
+    XcpUtl_ZeroMem(XcpDaq_PlanLists, sizeof(XcpDaq_PlanLists));
+    XcpUtl_ZeroMem(&XcpDaq_PlanStatistics, sizeof(XcpDaq_PlanStatistics));
+    XcpDaq_PlanOdtCount   = UINT16(0);
+    XcpDaq_PlanEntryCount = UINT16(0);
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    XcpDaq_PlanBitsCount = UINT16(0);
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_ENABLE_STIM == XCP_ON
+    XcpDaq_ResetStim();
+#endif /* XCP_ENABLE_STIM */
+}
+
+/** @brief Compiles the sampling plans of the DAQ lists about to be started.
+ *
+ *  Plans of running lists are left alone, events may be sampling them right now; the plans of
+ *  the lists to be started are appended. The sampling plan starts over only if no list is running,
+ *  so the space of lists stopped meanwhile is reclaimed at the latest then -- a list whose plan was
+ *  the last one appended reuses its space right away.
+ *
+ *  @param daqListNumber    DAQ list to be started, or XCP_DAQ_NO_LIST for all selected lists.
+ *  @return ERR_SUCCESS, or the error of the first list that failed; the lists are all or none compiled.
+ */
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileSamplingPlan(XcpDaq_ListIntegerType daqListNumber) {
+    XcpDaq_ListIntegerType      listIdx   = (XcpDaq_ListIntegerType)0;
+    XcpDaq_ListIntegerType      listCount = XcpDaq_GetListCount();
+    XcpDaq_ListStateType const *listState = XCP_NULL;
+    XcpDaq_PlanListType        *planList  = XCP_NULL;
+    XcpDaq_PlanMarkType         fill;
+    XcpDaq_PlanMarkType         rollback;
+    bool                        compiled  = (bool)XCP_FALSE;
+    Xcp_ReturnType              result    = ERR_SUCCESS;
+
+    XCP_DAQ_ENTER_CRITICAL();
+    if (!XcpDaq_AnyListStarted()) {
+        XcpDaq_ClearSamplingPlan();
+    }
+    XcpDaq_GetPlanMark(&rollback);
+    for (listIdx = (XcpDaq_ListIntegerType)0; (listIdx < listCount) && (result == ERR_SUCCESS); ++listIdx) {
+        listState = XcpDaq_GetListState(listIdx);
+        if (((listState->mode & XCP_DAQ_LIST_MODE_STARTED) == XCP_DAQ_LIST_MODE_STARTED) ||
+            ((daqListNumber != XCP_DAQ_NO_LIST) && (listIdx != daqListNumber)) ||
+            ((daqListNumber == XCP_DAQ_NO_LIST) && ((listState->mode & XCP_DAQ_LIST_MODE_SELECTED) != XCP_DAQ_LIST_MODE_SELECTED))) {
+            continue;
+        }
+        if (listIdx >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) {
+            result = ERR_MEMORY_OVERFLOW;
+            break;
+        }
+        planList = &XcpDaq_PlanLists[listIdx];
+        XcpDaq_GetPlanMark(&fill);
+        if (planList->valid && XcpDaq_PlanMarkEqual(&planList->end, &fill)) {
+            XcpDaq_SetPlanMark(&planList->begin);
+        }
+        planList->valid = (bool)XCP_FALSE;
+        XcpDaq_GetPlanMark(&planList->begin);
+        if (!compiled) {
+            rollback = planList->begin;
+            compiled = (bool)XCP_TRUE;
+        }
+        result          = XcpDaq_CompileListPlan(listIdx);
+        planList->valid = (bool)(result == ERR_SUCCESS);
+        XcpDaq_GetPlanMark(&planList->end);
+    }
+    if ((result != ERR_SUCCESS) && compiled) {
+        /* Nothing compiled by this call is kept. */
+        for (listIdx = (XcpDaq_ListIntegerType)0; (listIdx < listCount) && (listIdx < (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE);
+             ++listIdx) {
+            planList = &XcpDaq_PlanLists[listIdx];
+            if ((XcpDaq_GetListState(listIdx)->mode & XCP_DAQ_LIST_MODE_STARTED) != XCP_DAQ_LIST_MODE_STARTED) {
+                planList->valid = (bool)XCP_FALSE;
+            }
+        }
+        XcpDaq_SetPlanMark(&rollback);
+    }
+    XCP_DAQ_LEAVE_CRITICAL();
+    return result;
+}
+
+XCP_STATIC bool XcpDaq_AnyListStarted(void) {
+    XcpDaq_ListIntegerType listIdx = (XcpDaq_ListIntegerType)0;
+
+    for (listIdx = (XcpDaq_ListIntegerType)0; listIdx < XcpDaq_GetListCount(); ++listIdx) {
+        if ((XcpDaq_GetListState(listIdx)->mode & XCP_DAQ_LIST_MODE_STARTED) == XCP_DAQ_LIST_MODE_STARTED) {
+            return (bool)XCP_TRUE;
+        }
+    }
+    return (bool)XCP_FALSE;
+}
+
+XCP_STATIC void XcpDaq_GetPlanMark(XcpDaq_PlanMarkType *mark) {
+    mark->odts    = XcpDaq_PlanOdtCount;
+    mark->entries = XcpDaq_PlanEntryCount;
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    mark->bits = XcpDaq_PlanBitsCount;
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_ENABLE_STIM == XCP_ON
+    mark->stimBuffer = XcpDaq_StimBufferUsed;
+#endif /* XCP_ENABLE_STIM */
+}
+
+XCP_STATIC void XcpDaq_SetPlanMark(XcpDaq_PlanMarkType const *mark) {
+    XcpDaq_PlanOdtCount   = mark->odts;
+    XcpDaq_PlanEntryCount = mark->entries;
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    XcpDaq_PlanBitsCount = mark->bits;
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_ENABLE_STIM == XCP_ON
+    XcpDaq_StimBufferUsed = mark->stimBuffer;
+#endif /* XCP_ENABLE_STIM */
+}
+
+XCP_STATIC bool XcpDaq_PlanMarkEqual(XcpDaq_PlanMarkType const *mark, XcpDaq_PlanMarkType const *other) {
+    bool equal = (bool)((mark->odts == other->odts) && (mark->entries == other->entries));
+
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    equal = (bool)(equal && (mark->bits == other->bits));
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if XCP_ENABLE_STIM == XCP_ON
+    equal = (bool)(equal && (mark->stimBuffer == other->stimBuffer));
+#endif /* XCP_ENABLE_STIM */
+    return equal;
+}
+
+/** @brief Appends the sampling plan of a DAQ list.
+ *
+ *  @return ERR_DAQ_CONFIG if the configuration of the list can't be sampled,
+ *          ERR_MEMORY_OVERFLOW if the sampling plan (or STIM/snapshot buffer) is exhausted.
+ */
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileListPlan(XcpDaq_ListIntegerType daqListNumber) {
+    XcpDaq_ListConfigurationType const *listConf    = XcpDaq_GetListConfiguration(daqListNumber);
+    XcpDaq_ListStateType const         *listState   = XcpDaq_GetListState(daqListNumber);
+    XcpDaq_PlanListType                *planList    = &XcpDaq_PlanLists[daqListNumber];
+    XcpDaq_PlanOdtType                 *planOdt     = XCP_NULL;
+    XcpDaq_PlanEntryType               *planEntry   = XCP_NULL;
+    XcpDaq_ODTType const               *odt         = XCP_NULL;
+    XcpDaq_ODTEntryType                 entry;
+    XcpDaq_ODTIntegerType               odtIdx      = 0;
+    XcpDaq_ODTEntryIntegerType          odtEntryIdx = 0;
+    uint16_t                            firstEntry  = XcpDaq_PlanEntryCount;
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    XcpDaq_EventType const *event = XCP_NULL;
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+#if (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON)
+    uint32_t imageLength = UINT32(0);
+#endif /* (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON) */
+
+    if ((listConf == XCP_NULL) || (listState == XCP_NULL)) {
+        return ERR_DAQ_CONFIG;
+    }
+    if ((XcpDaq_PlanOdtCount + UINT16(listConf->numOdts)) > UINT16(XCP_DAQ_SAMPLING_PLAN_ODTS)) {
+        return ERR_MEMORY_OVERFLOW;
+    }
+    if (!XcpDaq_GetFirstPid(daqListNumber, &planList->firstPid)) {
+        return ERR_DAQ_CONFIG;
+    }
+#if XCP_DAQ_OVERLOAD_INDICATION == XCP_DAQ_OVERLOAD_INDICATION_PID
+    if ((UINT16(planList->firstPid) + UINT16(listConf->numOdts)) > UINT16(XCP_DAQ_OVERLOAD_PID_MSB)) {
+        return ERR_DAQ_CONFIG; /* PID MSB is reserved for overload indication. */
+    }
+#endif /* XCP_DAQ_OVERLOAD_INDICATION */
+    planList->firstOdt = XcpDaq_PlanOdtCount;
+    planList->numOdts  = (XcpDaq_ODTIntegerType)0;
+#if XCP_DAQ_ENABLE_PRIORITIZATION == XCP_ON
+    /* Priorities beyond the last queue share it, the list keeps the priority it was given. */
+    planList->queue = UINT8(XCP_MIN(UINT16(listState->priority), UINT16(XCP_DAQ_PRIORITY_QUEUES - 1)));
+#else
+    planList->queue = UINT8(0);
+#endif /* XCP_DAQ_ENABLE_PRIORITIZATION */
+    for (odtIdx = (XcpDaq_ODTIntegerType)0; odtIdx < listConf->numOdts; ++odtIdx) {
+        odt = XcpDaq_GetOdt(daqListNumber, odtIdx);
+        if (odt == XCP_NULL) {
+            return ERR_DAQ_CONFIG;
+        }
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+        /* Packed lists ignore ODT boundaries, entries are filled into as few DTOs as possible. */
+        if (!XcpDaq_PackedLists[daqListNumber] || (planOdt == XCP_NULL))
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+        {
+            planOdt = XcpDaq_BeginPlanOdt(planList, listState);
+            if (planOdt == XCP_NULL) {
+                return ERR_MEMORY_OVERFLOW;
+            }
+        }
+        for (odtEntryIdx = (XcpDaq_ODTEntryIntegerType)0; odtEntryIdx < odt->numOdtEntries; ++odtEntryIdx) {
+            entry = XcpDaq_GetOdtEntryValues(daqListNumber, odtIdx, odtEntryIdx);
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+            if (XcpDaq_PackedLists[daqListNumber] && (entry.length > (uint32_t)(XCP_MAX_DTO - planOdt->length))) {
+                planOdt = XcpDaq_BeginPlanOdt(planList, listState);
+                if (planOdt == XCP_NULL) {
+                    return ERR_MEMORY_OVERFLOW;
+                }
+            }
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+            if (entry.length > (uint32_t)(XCP_MAX_DTO - planOdt->length)) {
+                return ERR_DAQ_CONFIG; /* ODT doesn't fit into a DTO. */
+            }
+            XcpDaq_PlanStatistics.entries++;
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+            if ((entry.length == UINT32(1)) && (entry.bitOffset <= XCP_DAQ_MAX_BIT_OFFSET)) {
+                if (!XcpDaq_CompileBitEntry(planOdt, &entry, planOdt->length)) {
+                    return ERR_MEMORY_OVERFLOW;
+                }
+                planOdt->length += UINT16(1);
+                continue;
+            }
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+            if (XcpDaq_PlanContains(firstEntry, planOdt->firstEntry, entry.mta.address, entry.length)) {
+                /* Sampled by a preceding ODT of this list, too -- most likely a configuration issue. */
+                XcpDaq_PlanStatistics.duplicateEntries++;
+            }
+            if ((planOdt->numEntries > UINT16(0)) && ((planEntry->src + planEntry->length) == entry.mta.address) &&
+                ((planEntry->offset + planEntry->length) == planOdt->length)) {
+                /* Address-adjacent to the preceding entry (and not separated by bits): extend run. */
+                planEntry->length += UINT16(entry.length);
+                XcpDaq_PlanStatistics.copiesEliminated++;
+            } else {
+                if (XcpDaq_PlanEntryCount >= UINT16(XCP_DAQ_SAMPLING_PLAN_ENTRIES)) {
+                    return ERR_MEMORY_OVERFLOW;
+                }
+                planEntry         = &XcpDaq_PlanEntries[XcpDaq_PlanEntryCount];
+                planEntry->src    = entry.mta.address;
+                planEntry->length = UINT16(entry.length);
+                planEntry->offset = planOdt->length;
+                planOdt->numEntries++;
+                XcpDaq_PlanEntryCount++;
+                XcpDaq_PlanStatistics.runs++;
+            }
+            planOdt->length += UINT16(entry.length);
+        }
+    }
+#if (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON)
+    if (planOdt != XCP_NULL) {
+        imageLength = UINT32(planOdt->imageOffset) + UINT32(planOdt->length - planOdt->dataOffset);
+    }
+#endif /* (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON) */
+#if XCP_ENABLE_STIM == XCP_ON
+    planList->stim = ((listState->mode & XCP_DAQ_LIST_MODE_DIRECTION) == XCP_DAQ_LIST_MODE_DIRECTION);
+    if (planList->stim) {
+        return XcpDaq_CompileStimPlan(daqListNumber, imageLength);
+    }
+#endif /* XCP_ENABLE_STIM */
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    planList->snapshotLength = UINT16(0);
+    event                    = XcpDaq_GetEventConfiguration(listState->eventChannel);
+    if ((event != XCP_NULL) &&
+        ((event->properties & (XCP_DAQ_CONSISTENCY_DAQ_LIST | XCP_DAQ_CONSISTENCY_EVENT_CHANNEL)) != UINT8(0))) {
+        if (imageLength > UINT32(XCP_DAQ_SNAPSHOT_BUFFER_SIZE)) {
+            return ERR_MEMORY_OVERFLOW; /* Consistency can't be guaranteed. */
+        }
+        planList->snapshotLength = UINT16(imageLength);
+    }
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+    return ERR_SUCCESS;
+}
+
+/** @brief Appends an empty ODT, i.e. the next DTO, to the sampling plan of a DAQ list.
+ *
+ *  Only the first DTO of a list carries the timestamp, unless XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT is on.
+ */
+XCP_STATIC XcpDaq_PlanOdtType *XcpDaq_BeginPlanOdt(XcpDaq_PlanListType *planList, XcpDaq_ListStateType const *listState) {
+    XcpDaq_PlanOdtType *planOdt = XCP_NULL;
+#if (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON)
+    XcpDaq_PlanOdtType const *previous = XCP_NULL;
+#endif /* (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON) */
+
+    if (XcpDaq_PlanOdtCount >= UINT16(XCP_DAQ_SAMPLING_PLAN_ODTS)) {
+        return XCP_NULL;
+    }
+    planOdt             = &XcpDaq_PlanOdts[XcpDaq_PlanOdtCount];
+    planOdt->firstEntry = XcpDaq_PlanEntryCount;
+    planOdt->numEntries = UINT16(0);
+    planOdt->length     = XcpDaq_DtoHeaderLength(listState->mode, planList->numOdts);
+    planOdt->timestamp  = (bool)(planOdt->length > XCP_DAQ_PID_SIZE);
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    planOdt->firstBits = XcpDaq_PlanBitsCount;
+    planOdt->numBits   = UINT16(0);
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+#if (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON)
+    planOdt->dataOffset  = planOdt->length;
+    planOdt->imageOffset = UINT16(0);
+    if (planList->numOdts > (XcpDaq_ODTIntegerType)0) {
+        previous             = planOdt - 1;
+        planOdt->imageOffset = UINT16(previous->imageOffset + (previous->length - previous->dataOffset));
+    }
+#endif /* (XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON) || (XCP_ENABLE_STIM == XCP_ON) */
+    planList->numOdts++;
+    XcpDaq_PlanOdtCount++;
+    return planOdt;
+}
+
+/** @brief Size of identification field and timestamp of a DTO.
+ *
+ *  @param mode     Mode of the DAQ list.
+ *  @param dto      Number of the DTO within its DAQ list.
+ */
+XCP_STATIC uint16_t XcpDaq_DtoHeaderLength(uint8_t mode, XcpDaq_ODTIntegerType dto) {
+    uint16_t length = XCP_DAQ_PID_SIZE;
+
+#if XCP_DAQ_ENABLE_TIMESTAMPING == XCP_ON
+    if (((mode & XCP_DAQ_LIST_MODE_TIMESTAMP) == XCP_DAQ_LIST_MODE_TIMESTAMP) && XCP_DAQ_TIMESTAMPED_DTO(dto)) {
+        length += UINT16(XCP_DAQ_DTO_TIMESTAMP_SIZE);
+    }
+#else
+    XCP_UNREFERENCED_PARAMETER(mode);
+    XCP_UNREFERENCED_PARAMETER(dto);
+#endif /* XCP_DAQ_ENABLE_TIMESTAMPING */
+    return length;
+}
+
+/** @brief Checks if a memory area is completely covered by one of the given plan entries.
+ *
+ *  @param firstEntry   Index of the first plan entry to check.
+ *  @param lastEntry    Index one past the last plan entry to check.
+ */
+XCP_STATIC bool XcpDaq_PlanContains(uint16_t firstEntry, uint16_t lastEntry, Xcp_PointerSizeType address, uint32_t length) {
+    XcpDaq_PlanEntryType const *planEntry = XCP_NULL;
+    uint16_t                    idx       = UINT16(0);
+
+    for (idx = firstEntry; idx < lastEntry; ++idx) {
+        planEntry = &XcpDaq_PlanEntries[idx];
+        if ((address >= planEntry->src) && ((address + length) <= (planEntry->src + planEntry->length))) {
+            return (bool)XCP_TRUE;
+        }
+    }
+    return (bool)XCP_FALSE;
+}
+
+#if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+/** @brief Adds a single-bit entry to the bit groups of an ODT.
+ *
+ *  Bits of the same byte going to adjacent DTO bytes in ascending order share one group,
+ *  so the source byte is loaded only once per sampling.
+ *
+ *  @param offset   Destination offset within DTO.
+ */
+XCP_STATIC bool XcpDaq_CompileBitEntry(XcpDaq_PlanOdtType *planOdt, XcpDaq_ODTEntryType const *entry, uint16_t offset) {
+    XcpDaq_PlanBitsType *planBits = XCP_NULL;
+    Xcp_PointerSizeType  address  = entry->mta.address;
+    uint8_t              shift    = UINT8(entry->bitOffset & UINT8(0x07));
+
+    /* Bit offset refers to the 32-bit word at the entry address. */
+    #if XCP_BYTE_ORDER == XCP_BYTE_ORDER_INTEL
+    address += (Xcp_PointerSizeType)(entry->bitOffset >> 3);
+    #elif XCP_BYTE_ORDER == XCP_BYTE_ORDER_MOTOROLA
+    address += (Xcp_PointerSizeType)(UINT8(3) - (entry->bitOffset >> 3));
+    #endif /* XCP_BYTE_ORDER */
+    if (planOdt->numBits > UINT16(0)) {
+        planBits = &XcpDaq_PlanBits[XcpDaq_PlanBitsCount - UINT16(1)];
+        if ((planBits->src == address) && ((planBits->shift + planBits->count) == shift) &&
+            ((planBits->offset + planBits->count) == offset)) {
+            planBits->count++;
+            XcpDaq_PlanStatistics.copiesEliminated++;
+            return (bool)XCP_TRUE;
+        }
+    }
+    if (XcpDaq_PlanBitsCount >= UINT16(XCP_DAQ_SAMPLING_PLAN_ENTRIES)) {
+        return (bool)XCP_FALSE;
+    }
+    planBits         = &XcpDaq_PlanBits[XcpDaq_PlanBitsCount];
+    planBits->src    = address;
+    planBits->offset = offset;
+    planBits->shift  = shift;
+    planBits->count  = UINT8(1);
+    planOdt->numBits++;
+    XcpDaq_PlanBitsCount++;
+    XcpDaq_PlanStatistics.runs++;
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Extracts the bits of an ODT, one byte (0 or 1) per bit.
+ *
+ *  Branch-free: one load per group, then a shift and mask per bit.
+ *
+ *  @param data         Destination, holding the DTO from dataOffset on.
+ *  @param dataOffset   DTO offset data refers to.
+ */
+XCP_STATIC void XcpDaq_SampleBits(XcpDaq_PlanOdtType const *planOdt, uint8_t *data, uint16_t dataOffset) {
+    XcpDaq_PlanBitsType const *planBits = &XcpDaq_PlanBits[planOdt->firstBits];
+    XcpDaq_PlanBitsType const *last     = &XcpDaq_PlanBits[planOdt->firstBits + planOdt->numBits];
+    uint8_t                   *dst      = XCP_NULL;
+    uint8_t                    value    = UINT8(0);
+    uint8_t                    idx      = UINT8(0);
+
+    for (; planBits < last; ++planBits) {
+        value = UINT8(*(uint8_t const *)planBits->src >> planBits->shift);
+        dst   = &data[planBits->offset - dataOffset];
+        for (idx = UINT8(0); idx < planBits->count; ++idx) {
+            dst[idx] = UINT8((value >> idx) & UINT8(1));
+        }
+    }
+}
+#endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+/** @brief Captures all entries of a DAQ list into a staging buffer in one tight pass.
+ *
+ *  Retried (up to XCP_DAQ_SNAPSHOT_RETRIES times, with back-off) if the application updated
+ *  measurement variables meanwhile, see XcpDaq_UpdateBegin().
+ *
+ *  @return XCP_FALSE if no consistent snapshot could be taken.
+ */
+XCP_STATIC bool XcpDaq_TakeSnapshot(XcpDaq_PlanListType const *planList, uint8_t *snapshot) {
+    XcpDaq_PlanOdtType const   *first     = &XcpDaq_PlanOdts[planList->firstOdt];
+    XcpDaq_PlanOdtType const   *last      = &XcpDaq_PlanOdts[planList->firstOdt + planList->numOdts];
+    XcpDaq_PlanOdtType const   *planOdt   = XCP_NULL;
+    XcpDaq_PlanEntryType const *planEntry = XCP_NULL;
+    XcpDaq_PlanEntryType const *lastEntry = XCP_NULL;
+    uint8_t                    *dst       = XCP_NULL;
+    uint32_t                    done      = UINT32(0);
+    uint8_t                     attempt   = UINT8(0);
+
+    for (attempt = UINT8(0); attempt <= UINT8(XCP_DAQ_SNAPSHOT_RETRIES); ++attempt) {
+        if (attempt > UINT8(0)) {
+            XcpDaq_SnapshotBackoff(attempt);
+        }
+        done = XcpDaq_SnapshotLoad(XcpDaq_UpdatesDone);
+        if (XcpDaq_SnapshotLoad(XcpDaq_UpdatesActive) != UINT32(0)) {
+            continue;
+        }
+        for (planOdt = first; planOdt < last; ++planOdt) {
+            /* Laid out like the DTO payload, so it's sent with a single copy per ODT. */
+            dst       = &snapshot[planOdt->imageOffset];
+            lastEntry = &XcpDaq_PlanEntries[planOdt->firstEntry + planOdt->numEntries];
+            for (planEntry = &XcpDaq_PlanEntries[planOdt->firstEntry]; planEntry < lastEntry; ++planEntry) {
+                XcpDaq_CopyMemory(&dst[planEntry->offset - planOdt->dataOffset], (void const *)planEntry->src, planEntry->length);
+            }
+    #if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+            XcpDaq_SampleBits(planOdt, dst, planOdt->dataOffset);
+    #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+        }
+        XcpDaq_SnapshotFence();
+        if ((XcpDaq_SnapshotLoad(XcpDaq_UpdatesActive) == UINT32(0)) && (XcpDaq_SnapshotLoad(XcpDaq_UpdatesDone) == done)) {
+            return (bool)XCP_TRUE;
+        }
+    }
+    return (bool)XCP_FALSE;
+}
+
+/** @brief Waits for a running update to finish before the next snapshot attempt.
+ *
+ *  Busy waits (sampling may run in interrupt context) for at most XCP_DAQ_SNAPSHOT_BACKOFF
+ *  polls, doubled with every attempt; returns as soon as no update is active any more.
+ */
+XCP_STATIC void XcpDaq_SnapshotBackoff(uint8_t attempt) {
+    uint32_t polls = UINT32(XCP_DAQ_SNAPSHOT_BACKOFF) << XCP_MIN(attempt - UINT8(1), 16);
+
+    while ((polls > UINT32(0)) && (XcpDaq_SnapshotLoad(XcpDaq_UpdatesActive) != UINT32(0))) {
+        polls--;
+    }
+}
+
+/** @brief Marks the begin of an update of measurement variables sampled by consistent events.
+ *
+ *  Snapshots overlapping an update are retried; calls may be nested and come from several threads.
+ */
+void XcpDaq_UpdateBegin(void) {
+    XcpDaq_SnapshotIncrement(XcpDaq_UpdatesActive);
+}
+
+/** @brief Marks the end of an update started by XcpDaq_UpdateBegin().
+ */
+void XcpDaq_UpdateEnd(void) {
+    XcpDaq_SnapshotIncrement(XcpDaq_UpdatesDone);
+    XcpDaq_SnapshotDecrement(XcpDaq_UpdatesActive);
+}
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+
+#if XCP_ENABLE_STIM == XCP_ON
+XCP_STATIC void XcpDaq_ResetStim(void) {
+    uint16_t pid = UINT16(0);
+
+    for (pid = UINT16(0); pid < UINT16(XCP_DAQ_STIM_PID_LIMIT); ++pid) {
+        XcpDaq_StimListForPid[pid] = XCP_DAQ_NO_LIST;
+    }
+    XcpDaq_StimBufferUsed = UINT32(0);
+}
+
+/** @brief Assigns images and PIDs to a STIM list about to be started, the rest of its sampling plan is already compiled.
+ *
+ *  Whatever was staged for the list before is dropped, it starts over with the next complete image.
+ */
+XCP_STATIC Xcp_ReturnType XcpDaq_CompileStimPlan(XcpDaq_ListIntegerType daqListNumber, uint32_t imageLength) {
+    XcpDaq_PlanListType  *planList  = &XcpDaq_PlanLists[daqListNumber];
+    XcpDaq_StimStateType *stimState = &XcpDaq_StimStates[daqListNumber];
+    XcpDaq_ODTIntegerType odtIdx    = 0;
+
+    if ((UINT16(planList->firstPid) + UINT16(planList->numOdts)) > UINT16(XCP_DAQ_STIM_PID_LIMIT)) {
+        return ERR_DAQ_CONFIG; /* Not distinguishable from commands. */
+    }
+    if ((XcpDaq_StimBufferUsed + (UINT32(3) * imageLength)) > UINT32(XCP_DAQ_STIM_BUFFER_SIZE)) {
+        return ERR_MEMORY_OVERFLOW;
+    }
+    for (odtIdx = (XcpDaq_ODTIntegerType)0; odtIdx < planList->numOdts; ++odtIdx) {
+        XcpDaq_StimListForPid[planList->firstPid + odtIdx] = daqListNumber;
+    }
+    /* Locked against XcpDaq_ApplyStim(), which may still be running for the list if it was just stopped. */
+    XCP_STIM_ENTER_CRITICAL();
+    planList->imageLength = UINT16(imageLength);
+    stimState->images     = XcpDaq_StimBufferUsed;
+    stimState->nextOdt    = (XcpDaq_ODTIntegerType)0;
+    stimState->receiving  = UINT8(0);
+    stimState->applying   = UINT8(1);
+    (void)XcpDaq_StimExchangeHeld(stimState->latest, UINT8(2));
+    XCP_STIM_LEAVE_CRITICAL();
+    XcpDaq_StimBufferUsed += UINT32(3) * imageLength;
+    return ERR_SUCCESS;
+}
+
+/** @brief Stages a STIM DTO; called by the command processor for every packet with a PID below 0xC0.
+ *
+ *  ODTs are expected in order, an ODT out of sequence discards the current sample.
+ *  The image is handed over to the event once the last ODT has arrived.
+ *
+ *  @param[in]  dto  DTO starting with the identification field (PID).
+ *  @param[in]  len  Length of the DTO.
+ */
+void XcpDaq_StimReceive(uint8_t const *dto, uint16_t len) {
+    XcpDaq_ListIntegerType      daqListNumber = XCP_DAQ_NO_LIST;
+    XcpDaq_ListStateType const *listState     = XCP_NULL;
+    XcpDaq_PlanListType const  *planList      = XCP_NULL;
+    XcpDaq_PlanOdtType const   *planOdt       = XCP_NULL;
+    XcpDaq_StimStateType       *stimState     = XCP_NULL;
+    XcpDaq_ODTIntegerType       odtIdx        = 0;
+    uint16_t                    start         = UINT16(0);
+
+    if ((len < UINT16(1)) || (dto[0] >= UINT8(XCP_DAQ_STIM_PID_LIMIT))) {
+        return;
+    }
+    daqListNumber = XcpDaq_StimListForPid[dto[0]];
+    if (daqListNumber == XCP_DAQ_NO_LIST) {
+        return;
+    }
+    listState = XcpDaq_GetListState(daqListNumber);
+    planList  = &XcpDaq_PlanLists[daqListNumber];
+    if (((listState->mode & XCP_DAQ_LIST_MODE_STARTED) != XCP_DAQ_LIST_MODE_STARTED) || !planList->valid || !planList->stim) {
+        return;
+    }
+    stimState = &XcpDaq_StimStates[daqListNumber];
+    odtIdx    = (XcpDaq_ODTIntegerType)(dto[0] - planList->firstPid);
+    if (odtIdx != stimState->nextOdt) {
+        stimState->nextOdt = (XcpDaq_ODTIntegerType)0;
+        if (odtIdx != (XcpDaq_ODTIntegerType)0) {
+            return;
+        }
+    }
+    planOdt = &XcpDaq_PlanOdts[planList->firstOdt + odtIdx];
+    if (len < planOdt->length) {
+        stimState->nextOdt = (XcpDaq_ODTIntegerType)0;
+        return;
+    }
+    /* Image holds the payload following the PID (and timestamp) as is. */
+    start = planOdt->dataOffset;
+    XcpDaq_CopyMemory(
+        &XcpDaq_StimBuffers[stimState->images + (UINT32(stimState->receiving) * planList->imageLength) + planOdt->imageOffset],
+        &dto[start], UINT32(planOdt->length - start)
+    );
+    stimState->nextOdt++;
+    if (stimState->nextOdt == planList->numOdts) {
+        stimState->nextOdt = (XcpDaq_ODTIntegerType)0;
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+        stimState->receivedAt[stimState->receiving] = XcpHw_GetTimerCounter();
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+        stimState->receiving = UINT8(
+            XcpDaq_StimExchange(stimState->latest, UINT8(stimState->receiving | XCP_DAQ_STIM_FRESH)) & UINT8(~XCP_DAQ_STIM_FRESH)
+        );
+    }
+}
+
+/** @brief Writes the latest complete STIM image of a DAQ list to ECU memory, if there is a new one.
+ */
+XCP_STATIC void XcpDaq_ApplyStim(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ListStateType const *listState) {
+    XcpDaq_PlanListType const  *planList  = XCP_NULL;
+    XcpDaq_PlanOdtType const   *planOdt   = XCP_NULL;
+    XcpDaq_PlanOdtType const   *lastOdt   = XCP_NULL;
+    XcpDaq_PlanEntryType const *planEntry = XCP_NULL;
+    XcpDaq_PlanEntryType const *last      = XCP_NULL;
+    XcpDaq_StimStateType       *stimState = XCP_NULL;
+    uint8_t const              *image     = XCP_NULL;
+    uint8_t const              *src       = XCP_NULL;
+    #if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+    XcpDaq_PlanBitsType const *planBits = XCP_NULL;
+    XcpDaq_PlanBitsType const *lastBits = XCP_NULL;
+    uint8_t                    mask     = UINT8(0);
+    uint8_t                    value    = UINT8(0);
+    uint8_t                    idx      = UINT8(0);
+    #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    XcpDaq_RoundTripType *roundTrip  = &XcpDaq_RoundTrips[listState->eventChannel];
+    uint32_t              receivedAt = UINT32(0);
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+
+    if (((listState->mode & XCP_DAQ_LIST_MODE_STARTED) != XCP_DAQ_LIST_MODE_STARTED) ||
+        (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE)) {
+        return;
+    }
+    planList = &XcpDaq_PlanLists[daqListNumber];
+    if (!planList->valid || !planList->stim) {
+        return;
+    }
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    roundTrip->stimLists++;
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+    stimState = &XcpDaq_StimStates[daqListNumber];
+    if ((XcpDaq_StimLoad(stimState->latest) & XCP_DAQ_STIM_FRESH) == UINT8(0)) {
+        return; /* Nothing new received since the last event. */
+    }
+    XCP_STIM_ENTER_CRITICAL();
+    if ((XcpDaq_StimLoad(stimState->latest) & XCP_DAQ_STIM_FRESH) == UINT8(0)) {
+        XCP_STIM_LEAVE_CRITICAL();
+        return; /* Dropped by XcpDaq_CompileStimPlan() meanwhile. */
+    }
+    stimState->applying = UINT8(XcpDaq_StimExchangeHeld(stimState->latest, stimState->applying) & UINT8(~XCP_DAQ_STIM_FRESH));
+    #if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    receivedAt = stimState->receivedAt[stimState->applying];
+    if ((roundTrip->stimImages == UINT16(0)) || ((int32_t)(receivedAt - roundTrip->receivedAt) > 0)) {
+        roundTrip->receivedAt = receivedAt;
+    }
+    roundTrip->stimImages++;
+    #endif /* XCP_DAQ_ENABLE_BYPASS */
+    image   = &XcpDaq_StimBuffers[stimState->images + (UINT32(stimState->applying) * planList->imageLength)];
+    lastOdt = &XcpDaq_PlanOdts[planList->firstOdt + planList->numOdts];
+    #if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    XcpDaq_UpdateBegin();
+    #endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+    for (planOdt = &XcpDaq_PlanOdts[planList->firstOdt]; planOdt < lastOdt; ++planOdt) {
+        src  = &image[planOdt->imageOffset];
+        last = &XcpDaq_PlanEntries[planOdt->firstEntry + planOdt->numEntries];
+        for (planEntry = &XcpDaq_PlanEntries[planOdt->firstEntry]; planEntry < last; ++planEntry) {
+            XcpDaq_CopyMemory((void *)planEntry->src, &src[planEntry->offset - planOdt->dataOffset], planEntry->length);
+        }
+    #if XCP_DAQ_ENABLE_BIT_OFFSET == XCP_ON
+        /* Bits are merged into their bytes, leaving the other bits untouched. */
+        lastBits = &XcpDaq_PlanBits[planOdt->firstBits + planOdt->numBits];
+        for (planBits = &XcpDaq_PlanBits[planOdt->firstBits]; planBits < lastBits; ++planBits) {
+            mask  = UINT8(((UINT16(1) << planBits->count) - UINT16(1)) << planBits->shift);
+            value = UINT8(0);
+            for (idx = UINT8(0); idx < planBits->count; ++idx) {
+                value |= UINT8((src[planBits->offset - planOdt->dataOffset + idx] & UINT8(1)) << idx);
+            }
+            *(uint8_t *)planBits->src = UINT8((*(uint8_t const *)planBits->src & UINT8(~mask)) | UINT8(value << planBits->shift));
+        }
+    #endif /* XCP_DAQ_ENABLE_BIT_OFFSET */
+    }
+    #if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    XcpDaq_UpdateEnd();
+    #endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+    XCP_STIM_LEAVE_CRITICAL();
+}
+
+    #if XCP_DAQ_QUEUE_ATOMICS == XCP_OFF
+XCP_STATIC uint8_t XcpDaq_StimExchangeLocked(XcpDaq_StimImageType *image, uint8_t value) {
+    uint8_t previous = UINT8(0);
+
+    XCP_STIM_ENTER_CRITICAL();
+    previous = XcpDaq_StimSwap(image, value);
+    XCP_STIM_LEAVE_CRITICAL();
+    return previous;
+}
+
+XCP_STATIC uint8_t XcpDaq_StimSwap(XcpDaq_StimImageType *image, uint8_t value) {
+    const uint8_t previous = *image;
+
+    *image = value;
+    return previous;
+}
+    #endif /* XCP_DAQ_QUEUE_ATOMICS */
+#endif     /* XCP_ENABLE_STIM */
+
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+/** @brief Completes the round trip started by the previous occurrence of a bypass event, and starts the next one.
+ *
+ *  Called after all DAQ lists of the event are processed: the round trip was in time if each STIM list
+ *  got data received after the previous sampling.
+ */
+XCP_STATIC void XcpDaq_CloseRoundTrip(uint8_t eventChannelNumber, uint32_t timestamp) {
+    XcpDaq_EventType const      *event     = XcpDaq_GetEventConfiguration(eventChannelNumber);
+    XcpDaq_RoundTripType        *roundTrip = &XcpDaq_RoundTrips[eventChannelNumber];
+    XcpDaq_BypassStatisticsType *stats     = &XcpDaq_BypassStatistics[eventChannelNumber];
+    uint32_t                     latency   = UINT32(0);
+
+    if ((event == XCP_NULL) || ((event->properties & XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM) != XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM) ||
+        (roundTrip->stimLists == UINT16(0))) {
+        roundTrip->pending = (bool)XCP_FALSE;
+    } else {
+        if (roundTrip->pending) {
+            latency = roundTrip->receivedAt - roundTrip->sampledAt;
+            if ((roundTrip->stimImages == roundTrip->stimLists) && ((int32_t)latency >= 0)) {
+                if ((stats->cycles == UINT32(0)) || (latency < stats->minLatency)) {
+                    stats->minLatency = latency;
+                }
+                if (latency > stats->maxLatency) {
+                    stats->maxLatency = latency;
+                }
+                stats->latency = latency;
+                stats->cycles++;
+            } else {
+                /* Missing, or answering an earlier sample. */
+                stats->missedDeadlines++;
+            }
+        }
+        roundTrip->sampledAt = timestamp;
+        roundTrip->pending   = (bool)XCP_TRUE;
+    }
+    roundTrip->stimLists  = UINT16(0);
+    roundTrip->stimImages = UINT16(0);
+}
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+
+#if XCP_DAQ_ENABLE_EVENT_RATE_LIMITS == XCP_ON
+/** @brief Applies the rate limits of an event channel (prescaler first, then min. interval).
+ *
+ *  @return XCP_TRUE if the occurrence is to be processed.
+ */
+XCP_STATIC bool XcpDaq_EventDue(uint8_t eventChannelNumber, uint32_t timestamp) {
+    XcpDaq_EventType const    *event = &XcpDaq_Events[eventChannelNumber];
+    XcpDaq_EventRateStateType *rate  = &XcpDaq_EventRates[eventChannelNumber];
+
+    if (event->prescaler > UINT8(1)) {
+        rate->counter++;
+        if (rate->counter < event->prescaler) {
+            return (bool)XCP_FALSE;
+        }
+        rate->counter = UINT8(0);
+    }
+    if (event->minInterval > UINT32(0)) {
+        if (rate->processed && (((timestamp - rate->lastOccurrence) & XCP_DAQ_TIMER_MASK) < event->minInterval)) {
+            return (bool)XCP_FALSE;
+        }
+        rate->lastOccurrence = timestamp;
+        rate->processed      = (bool)XCP_TRUE;
+    }
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Scales a cycle time to fit into a byte, `decade` is the time unit as power of ten of 1ns.
+ */
+XCP_STATIC void XcpDaq_NormalizeCycle(uint32_t *cycle, int8_t *decade) {
+    while ((*cycle > UINT32(0xff)) && (*decade < (int8_t)9)) {
+        *cycle = (*cycle + UINT32(5)) / UINT32(10);
+        (*decade)++;
+    }
+    if (*cycle > UINT32(0xff)) {
+        *cycle = UINT32(0xff);
+    }
+}
+
+/** @brief Gets the cycle time an event channel is processed with, as reported by GET_DAQ_EVENT_INFO.
+ *
+ *  That's the nominal cycle times the prescaler, or the min. interval if longer;
+ *  sporadic events limited by a min. interval report that one.
+ *
+ *  @param[out] cycle     EVENT_CHANNEL_TIME_CYCLE, 0: not cyclic.
+ *  @param[out] timeunit  EVENT_CHANNEL_TIME_UNIT.
+ */
+void XcpDaq_GetEffectiveEventCycle(uint16_t eventChannelNumber, uint8_t *cycle, uint8_t *timeunit) {
+    XcpDaq_EventType const *event          = XcpDaq_GetEventConfiguration(eventChannelNumber);
+    uint32_t                period         = UINT32(0);
+    uint32_t                interval       = UINT32(0);
+    int8_t                  periodDecade   = (int8_t)0;
+    int8_t                  intervalDecade = (int8_t)0;
+
+    if (event == XCP_NULL) {
+        *cycle    = UINT8(0);
+        *timeunit = UINT8(0);
+        return;
+    }
+    /* Time units 10..12 (1ps..100ps) precede 0 (1ns). */
+    period       = UINT32(event->cycle) * UINT32(XCP_MAX(event->prescaler, UINT8(1)));
+    periodDecade = (event->timeunit >= UINT8(10)) ? (int8_t)(event->timeunit - 13) : (int8_t)event->timeunit;
+    XcpDaq_NormalizeCycle(&period, &periodDecade);
+    if (event->minInterval > UINT32(0)) {
+        interval       = event->minInterval;
+        intervalDecade = (XCP_DAQ_TIMESTAMP_UNIT >= 10) ? (int8_t)(XCP_DAQ_TIMESTAMP_UNIT - 13) : (int8_t)XCP_DAQ_TIMESTAMP_UNIT;
+        XcpDaq_NormalizeCycle(&interval, &intervalDecade);
+        if (period == UINT32(0)) {
+            period       = interval;
+            periodDecade = intervalDecade;
+        } else {
+            /* Compare in the finer unit; a value that can't be scaled down that far is the longer one anyway. */
+            while ((periodDecade > intervalDecade) && (period <= (UINT32(0xffffffff) / UINT32(10)))) {
+                period *= UINT32(10);
+                periodDecade--;
+            }
+            while ((intervalDecade > periodDecade) && (interval <= (UINT32(0xffffffff) / UINT32(10)))) {
+                interval *= UINT32(10);
+                intervalDecade--;
+            }
+            if ((intervalDecade > periodDecade) || ((intervalDecade == periodDecade) && (interval > period))) {
+                period       = interval;
+                periodDecade = intervalDecade;
+            }
+            XcpDaq_NormalizeCycle(&period, &periodDecade);
+        }
+    }
+    *cycle    = UINT8(period);
+    *timeunit = (periodDecade < (int8_t)0) ? UINT8(periodDecade + 13) : UINT8(periodDecade);
+}
+#endif /* XCP_DAQ_ENABLE_EVENT_RATE_LIMITS */
+
+void XcpDaq_GetPlanStatistics(XcpDaq_PlanStatisticsType *statistics) {
+    XCP_DAQ_ENTER_CRITICAL();
+    XcpUtl_MemCopy(statistics, &XcpDaq_PlanStatistics, sizeof(XcpDaq_PlanStatisticsType));
+    XCP_DAQ_LEAVE_CRITICAL();
+}
+
+/** @brief Looks up the absolute ODT number (PID) of the first ODT of a DAQ list.
+ *
+ *  PIDs are maintained by XcpDaq_Init() (predefined lists) and XcpDaq_Alloc()/XcpDaq_AllocOdt()
+ *  (dynamic lists), so this is a constant time operation.
+ */
+bool XcpDaq_GetFirstPid(XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType *firstPID) {
+    if (daqListNumber >= XcpDaq_GetListCount()) {
+        *firstPID = (XcpDaq_ODTIntegerType)0;
+        return (bool)XCP_FALSE;
+    }
+    *firstPID = XcpDaq_GetListState(daqListNumber)->firstPid;
+    return (bool)XCP_TRUE;
+}
+
+#if XCP_DAQ_ENABLE_ODT_PACKING == XCP_ON
+/** @brief Enables or disables packed mode of a stopped DAQ list.
+ *
+ *  Entries of a packed list are filled into as few DTOs as possible, regardless of the ODTs
+ *  they were written to; see XcpDaq_GetEntryPosition() for the resulting layout.
+ */
+Xcp_ReturnType XcpDaq_SetListPacking(XcpDaq_ListIntegerType daqListNumber, bool packed) {
+    if ((daqListNumber >= XcpDaq_GetListCount()) || (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE)) {
+        return ERR_OUT_OF_RANGE;
+    }
+    if ((XcpDaq_GetListState(daqListNumber)->mode & XCP_DAQ_LIST_MODE_STARTED) == XCP_DAQ_LIST_MODE_STARTED) {
+        return ERR_DAQ_ACTIVE;
+    }
+    XcpDaq_PackedLists[daqListNumber] = packed;
+    return ERR_SUCCESS;
+}
+
+/** @brief Locates an ODT entry within the DTOs of its DAQ list, as sampled with the current list mode.
+ *
+ *  @param[out] pid     Identification field (absolute ODT number) of the DTO.
+ *  @param[out] offset  Position within the DTO, incl. identification field and timestamp.
+ */
+bool XcpDaq_GetEntryPosition(
+    XcpDaq_ListIntegerType daqListNumber, XcpDaq_ODTIntegerType odtNumber, XcpDaq_ODTEntryIntegerType odtEntryNumber,
+    XcpDaq_ODTIntegerType *pid, uint16_t *offset
+) {
+    XcpDaq_ListConfigurationType const *listConf    = XCP_NULL;
+    XcpDaq_ODTType const               *odt         = XCP_NULL;
+    XcpDaq_ODTEntryType                 entry;
+    XcpDaq_ODTIntegerType               odtIdx      = 0;
+    XcpDaq_ODTEntryIntegerType          odtEntryIdx = 0;
+    XcpDaq_ODTIntegerType               dto         = 0;
+    uint16_t                            position    = UINT16(0);
+    bool                                packed      = (bool)XCP_FALSE;
+    uint8_t                             mode        = UINT8(0);
+
+    if (!XcpDaq_GetFirstPid(daqListNumber, pid) || (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE)) {
+        return (bool)XCP_FALSE;
+    }
+    listConf = XcpDaq_GetListConfiguration(daqListNumber);
+    packed   = XcpDaq_PackedLists[daqListNumber];
+    mode     = XcpDaq_GetListState(daqListNumber)->mode;
+    position = XcpDaq_DtoHeaderLength(mode, dto);
+    /* Same walk as XcpDaq_CompileListPlan(), so the master can be told before the list is started. */
+    for (odtIdx = (XcpDaq_ODTIntegerType)0; (odtIdx < listConf->numOdts) && (odtIdx <= odtNumber); ++odtIdx) {
+        odt = XcpDaq_GetOdt(daqListNumber, odtIdx);
+        if (odt == XCP_NULL) {
+            return (bool)XCP_FALSE;
+        }
+        if (!packed && (odtIdx > (XcpDaq_ODTIntegerType)0)) {
+            dto++;
+            position = XcpDaq_DtoHeaderLength(mode, dto);
+        }
+        for (odtEntryIdx = (XcpDaq_ODTEntryIntegerType)0; odtEntryIdx < odt->numOdtEntries; ++odtEntryIdx) {
+            entry = XcpDaq_GetOdtEntryValues(daqListNumber, odtIdx, odtEntryIdx);
+            if (packed && (entry.length > (uint32_t)(XCP_MAX_DTO - position))) {
+                dto++;
+                position = XcpDaq_DtoHeaderLength(mode, dto);
+            }
+            if ((odtIdx == odtNumber) && (odtEntryIdx == odtEntryNumber)) {
+                *pid += dto;
+                *offset = position;
+                return (bool)XCP_TRUE;
+            }
+            position += UINT16(entry.length);
+        }
+    }
+    return (bool)XCP_FALSE;
+}
+#endif /* XCP_DAQ_ENABLE_ODT_PACKING */
+
+/*
+**  Debugging / Testing interface.
 */
 #if XCP_BUILD_TYPE == XCP_DEBUG_BUILD
 
@@ -947,7 +2857,11 @@ XcpDaq_EntityType *XcpDaq_GetDynamicEntity(uint16_t num) {
 }
 
 void XcpDaq_QueueGetVar(XcpDaq_QueueType *var) {
-    XcpUtl_MemCopy(var, &XcpDaq_Queue, sizeof(XcpDaq_QueueType));
+    var->head = (XCP_DAQ_QUEUE_INDEX_TYPE)(XcpDaq_QueueLoad(XcpDaq_Queue[0].head) &
+                                           (XcpDaq_QueuePositionType)(XCP_DAQ_PRIORITY_QUEUE_SIZE - 1));
+    var->tail = (XCP_DAQ_QUEUE_INDEX_TYPE)(XcpDaq_QueueLoad(XcpDaq_Queue[0].tail) &
+                                           (XcpDaq_QueuePositionType)(XCP_DAQ_PRIORITY_QUEUE_SIZE - 1));
+    var->overload = (bool)(XcpDaq_QueueLoad(XcpDaq_QueueOverload) != 0U);
 }
 
 #endif /* XCP_BUILD_TYPE */
@@ -955,47 +2869,439 @@ void XcpDaq_QueueGetVar(XcpDaq_QueueType *var) {
 // #if XCP_DAQ_ENABLE_DYNAMIC_LISTS == XCP_ON
 
 #if XCP_DAQ_ENABLE_QUEUING == XCP_ON
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+        #define XCP_DAQ_QUEUE_LAP(pos) ((pos) & ~(XcpDaq_QueuePositionType)(XCP_DAQ_PRIORITY_QUEUE_SIZE - 1))
+        #define XCP_DAQ_EVENT_LAP(pos) ((pos) & ~(XcpDaq_QueuePositionType)(XCP_DAQ_QUEUE_SIZE - 1))
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+
+/** @brief Discards all pending DTOs.
+ *
+ *  Like everything that moves `tail`, this is done by the consumer: right here if the queue is idle,
+ *  otherwise by the next run of XcpDaq_TransmitDtos(). New reservations fail until then, and
+ *  DTOs already being assembled are committed before the queue is reset.
+ */
 void XcpDaq_QueueInit(void) {
-    uint8_t idx;
+    XcpDaq_QueueIncrement(XcpDaq_QueueDiscards);
+    XcpDaq_QueueStore(XcpDaq_QueueOverload, 0U);
+    if (XcpDaq_QueueClaim()) {
+        (void)XcpDaq_QueueDiscard();
+        XcpDaq_QueueUnclaim();
+    }
+}
+
+/** @brief Takes the consumer role, i.e. the right to move `tail`; there is at most one consumer at any time.
+ *
+ *  @return XCP_FALSE if the queue is already being consumed.
+ *  @note   The DAQ lock is only held to flip the flag, never while DTOs are in transit.
+ */
+XCP_STATIC bool XcpDaq_QueueClaim(void) {
+    bool claimed = (bool)XCP_FALSE;
+
+    XCP_DAQ_ENTER_CRITICAL();
+    claimed              = (bool)!XcpDaq_QueueConsumed;
+    XcpDaq_QueueConsumed = (bool)XCP_TRUE;
+    XCP_DAQ_LEAVE_CRITICAL();
+    return claimed;
+}
+
+/** @brief Gives up the consumer role taken by XcpDaq_QueueClaim().
+ */
+XCP_STATIC void XcpDaq_QueueUnclaim(void) {
+    XCP_DAQ_ENTER_CRITICAL();
+    XcpDaq_QueueConsumed = (bool)XCP_FALSE;
+    XCP_DAQ_LEAVE_CRITICAL();
+}
+
+/** @brief Carries out pending discard requests of XcpDaq_QueueInit().
+ *
+ *  The queue is closed for new reservations first; it is reset (and reopened) only after the
+ *  producers still holding a reservation have committed. We don't wait for them, they may
+ *  well be preempted by us.
+ *
+ *  @return XCP_FALSE if a discard is still pending, i.e. the queue must not be consumed.
+ *  @note   Consumer side only.
+ */
+XCP_STATIC bool XcpDaq_QueueDiscard(void) {
+    const XcpDaq_QueuePositionType requests = XcpDaq_QueueLoad(XcpDaq_QueueDiscards);
+    uint32_t                       idx      = UINT32(0);
+    uint8_t                        level    = UINT8(0);
 
-    XcpDaq_Queue.head = XcpDaq_Queue.tail = UINT8(0);
-    XcpDaq_Queue.overload                 = (bool)XCP_FALSE;
-    for (idx = UINT8(0); idx < UINT8(XCP_DAQ_QUEUE_SIZE); ++idx) {
-        // XcpUtl_ZeroMem(&XcpDaq_QueueDTOs[idx], sizeof(Xcp_PduType));
-        XcpUtl_ZeroMem(&XcpDaq_QueueDTOs[idx], sizeof(XcpDaq_QueueDTOs[idx]));
+    if (requests == XcpDaq_QueueLoad(XcpDaq_QueueDiscarded)) {
+        return (bool)XCP_TRUE;
     }
+    XcpDaq_QueueStore(XcpDaq_QueueClosed, 1U);
+    XcpDaq_QueueFence(); /* Pairs with XcpDaq_QueueEnter(). */
+    if (XcpDaq_QueueLoadAcquire(XcpDaq_QueueProducers) != 0U) {
+        return (bool)XCP_FALSE;
+    }
+    for (level = UINT8(0); level < UINT8(XCP_DAQ_PRIORITY_QUEUES); ++level) {
+        XcpDaq_QueueStore(XcpDaq_Queue[level].head, (XcpDaq_QueuePositionType)0);
+        XcpDaq_QueueStore(XcpDaq_Queue[level].tail, (XcpDaq_QueuePositionType)0);
+        for (idx = UINT32(0); idx < UINT32(XCP_DAQ_PRIORITY_QUEUE_SIZE); ++idx) {
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+            XcpDaq_QueueStore(XcpDaq_QueueDTOs[level][idx].sequence, (XcpDaq_QueuePositionType)0);
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+            XcpDaq_QueueDTOs[level][idx].owner = XCP_DAQ_NO_LIST;
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+        }
+    }
+    XcpDaq_QueuePeeked = UINT8(0);
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+    for (idx = UINT32(0); idx < UINT32(XCP_DAQ_SAMPLING_PLAN_SIZE); ++idx) {
+        XcpDaq_QueueStore(XcpDaq_QueueUsage[idx], (XcpDaq_QueuePositionType)0);
+    }
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+    XcpDaq_QueueStore(XcpDaq_QueueDiscarded, requests);
+    XcpDaq_QueueStoreRelease(XcpDaq_QueueClosed, 0U);
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Registers a producer, unless the queue is closed by XcpDaq_QueueDiscard().
+ *
+ *  @return XCP_FALSE if the queue is closed.
+ *  @note   Producer side; a successful call is paired with XcpDaq_QueueLeave().
+ */
+XCP_STATIC bool XcpDaq_QueueEnter(void) {
+    if (XcpDaq_QueueLoad(XcpDaq_QueueClosed) != 0U) {
+        return (bool)XCP_FALSE; /* Keep off the counter, so the consumer gets to see it drop to zero. */
+    }
+    XcpDaq_QueueIncrement(XcpDaq_QueueProducers);
+    XcpDaq_QueueFence(); /* Either we see the queue closed, or the consumer sees us. */
+    if (XcpDaq_QueueLoadAcquire(XcpDaq_QueueClosed) != 0U) {
+        XcpDaq_QueueLeave();
+        return (bool)XCP_FALSE;
+    }
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Deregisters a producer, see XcpDaq_QueueEnter().
+ */
+XCP_STATIC void XcpDaq_QueueLeave(void) {
+    XcpDaq_QueueDecrementRelease(XcpDaq_QueueProducers);
+}
+
+/** @brief Checks if the consumer has something to do, i.e. a DTO is ready or a discard was requested.
+ */
+XCP_STATIC bool XcpDaq_QueuePending(void) {
+    uint8_t level = UINT8(0);
+
+    if (XcpDaq_QueueLoad(XcpDaq_QueueDiscards) != XcpDaq_QueueLoad(XcpDaq_QueueDiscarded)) {
+        return (bool)XCP_TRUE;
+    }
+    for (level = UINT8(0); level < UINT8(XCP_DAQ_PRIORITY_QUEUES); ++level) {
+        if (XcpDaq_QueueLevelReady(level)) {
+            return (bool)XCP_TRUE;
+        }
+    }
+    return (bool)XCP_FALSE;
+}
+
+XCP_STATIC XcpDaq_OdtType *XcpDaq_QueueSlotFromDto(uint8_t const *dto) {
+    const Xcp_PointerSizeType offset =
+        (Xcp_PointerSizeType)dto - (Xcp_PointerSizeType)&XcpDaq_QueueDTOs[0][0].data[XCP_TRANSPORT_LAYER_BUFFER_OFFSET];
+
+    return &XcpDaq_QueueDTOs[0][0] + (offset / (Xcp_PointerSizeType)sizeof(XcpDaq_OdtType));
+}
+
+XCP_STATIC bool XcpDaq_QueueLevelFull(uint8_t level) {
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    const XcpDaq_QueuePositionType head = XcpDaq_QueueLoad(XcpDaq_Queue[level].head);
+
+    return XcpDaq_QueueLoadAcquire(XCP_DAQ_QUEUE_SLOT(level, head)->sequence) != XCP_DAQ_QUEUE_LAP(head);
+    #else
+    return (XcpDaq_QueuePositionType)(XcpDaq_QueueLoad(XcpDaq_Queue[level].head) -
+                                      XcpDaq_QueueLoadAcquire(XcpDaq_Queue[level].tail)) >=
+           (XcpDaq_QueuePositionType)XCP_DAQ_PRIORITY_QUEUE_SIZE;
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
 }
 
+/** @brief Checks if the oldest DTO of a priority queue is ready for transmission.
+ */
+XCP_STATIC bool XcpDaq_QueueLevelReady(uint8_t level) {
+    const XcpDaq_QueuePositionType tail = XcpDaq_QueueLoad(XcpDaq_Queue[level].tail);
+
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    /* DTOs are sent in reservation order, i.e. the oldest one must be committed first. */
+    return XcpDaq_QueueLoadAcquire(XCP_DAQ_QUEUE_SLOT(level, tail)->sequence) == (XCP_DAQ_QUEUE_LAP(tail) + 1UL);
+    #else
+    return XcpDaq_QueueLoadAcquire(XcpDaq_Queue[level].head) != tail;
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+}
+
+/** @brief Checks if the lowest priority queue (used by XcpDaq_QueueReserve()) is full.
+ */
 XCP_STATIC bool XcpDaq_QueueFull(void) {
-    return ((XcpDaq_Queue.head + UINT8(1)) % UINT8(XCP_DAQ_QUEUE_SIZE)) == XcpDaq_Queue.tail;
+    return XcpDaq_QueueLevelFull(UINT8(0));
 }
 
 bool XcpDaq_QueueEmpty(void) {
-    return XcpDaq_Queue.head == XcpDaq_Queue.tail;
+    uint8_t level = UINT8(0);
+
+    for (level = UINT8(0); level < UINT8(XCP_DAQ_PRIORITY_QUEUES); ++level) {
+        if (XcpDaq_QueueLoadAcquire(XcpDaq_Queue[level].head) != XcpDaq_QueueLoadAcquire(XcpDaq_Queue[level].tail)) {
+            return (bool)XCP_FALSE;
+        }
+    }
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Reserves the next free slot of a priority queue, so a DTO can be assembled in place.
+ *
+ *  @param level    Priority queue, 0 is the lowest priority.
+ *  @return Pointer to the DTO area of the slot (XCP_MAX_DTO bytes, preceded by
+ *          XCP_TRANSPORT_LAYER_BUFFER_OFFSET bytes of headroom) or XCP_NULL if the queue is full
+ *          (or about to be discarded).
+ *  @note   Producer side; finish with XcpDaq_QueueCommit(). Without XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS
+ *          at most one slot per queue may be reserved at any time.
+ */
+XCP_STATIC uint8_t *XcpDaq_QueueReserveLevel(uint8_t level) {
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    XcpDaq_QueuePositionType head = (XcpDaq_QueuePositionType)0;
+    XcpDaq_OdtType          *slot = XCP_NULL;
+    int32_t                  dif  = 0;
+
+    if (!XcpDaq_QueueEnter()) {
+        return XCP_NULL;
+    }
+    head = XcpDaq_QueueLoad(XcpDaq_Queue[level].head);
+    XCP_FOREVER {
+        slot = XCP_DAQ_QUEUE_SLOT(level, head);
+        dif  = (int32_t)(XcpDaq_QueueLoadAcquire(slot->sequence) - XCP_DAQ_QUEUE_LAP(head));
+        if (dif == 0) {
+            /* Slot is free, try to claim it (on failure `head` is reloaded). */
+            if (atomic_compare_exchange_weak_explicit(
+                    &XcpDaq_Queue[level].head, &head, head + 1UL, memory_order_relaxed, memory_order_relaxed
+                )) {
+        #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+                slot->owner = XCP_DAQ_NO_LIST;
+        #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+        #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+                slot->event = XCP_DAQ_LATENCY_NO_EVENT;
+        #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+                return &slot->data[XCP_TRANSPORT_LAYER_BUFFER_OFFSET];
+            }
+        } else if (dif < 0) {
+            /* Slot still holds a DTO of the previous lap. */
+            XcpDaq_QueueLeave();
+            XcpDaq_QueueStore(XcpDaq_QueueOverload, 1U);
+            return XCP_NULL;
+        } else {
+            /* Another producer was faster. */
+            head = XcpDaq_QueueLoad(XcpDaq_Queue[level].head);
+        }
+    }
+    #else
+    XcpDaq_OdtType *slot = XCP_NULL;
+
+    if (!XcpDaq_QueueEnter()) {
+        return XCP_NULL;
+    }
+    if (XcpDaq_QueueLevelFull(level)) {
+        XcpDaq_QueueLeave();
+        XcpDaq_QueueStore(XcpDaq_QueueOverload, 1U);
+        return XCP_NULL;
+    }
+    slot = XCP_DAQ_QUEUE_SLOT(level, XcpDaq_QueueLoad(XcpDaq_Queue[level].head));
+        #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+    slot->owner = XCP_DAQ_NO_LIST;
+        #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+        #if XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS == XCP_ON
+    slot->event = XCP_DAQ_LATENCY_NO_EVENT;
+        #endif /* XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS */
+    return &slot->data[XCP_TRANSPORT_LAYER_BUFFER_OFFSET];
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
 }
 
+/** @brief Reserves the next free slot of the lowest priority queue, see XcpDaq_QueueReserveLevel().
+ */
+uint8_t *XcpDaq_QueueReserve(void) {
+    return XcpDaq_QueueReserveLevel(UINT8(0));
+}
+
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+/** @brief Like XcpDaq_QueueReserveLevel(), but the slot is accounted to the budget of a DAQ list.
+ */
+XCP_STATIC uint8_t *XcpDaq_QueueReserveForList(XcpDaq_ListIntegerType daqListNumber, uint8_t level) {
+    const XCP_DAQ_QUEUE_INDEX_TYPE budget = XcpDaq_QueueBudgets[daqListNumber];
+    uint8_t                       *dto    = XCP_NULL;
+
+    if ((budget != (XCP_DAQ_QUEUE_INDEX_TYPE)0) && (XcpDaq_QueueLoad(XcpDaq_QueueUsage[daqListNumber]) >= budget)) {
+        XcpDaq_QueueStore(XcpDaq_QueueOverload, 1U);
+        return XCP_NULL;
+    }
+    dto = XcpDaq_QueueReserveLevel(level);
+    if (dto != XCP_NULL) {
+        XcpDaq_QueueIncrement(XcpDaq_QueueUsage[daqListNumber]);
+        XcpDaq_QueueSlotFromDto(dto)->owner = daqListNumber;
+    }
+    return dto;
+}
+
+/** @brief Limits the number of queue slots a DAQ list may occupy, so bursts of one list can't starve others.
+ *
+ *  @param daqListNumber    DAQ list.
+ *  @param budget           Max. number of slots, 0 means unlimited (default).
+ *  @note  Budgets aren't affected by FREE_DAQ/ALLOC_DAQ.
+ */
+void XcpDaq_SetListQueueBudget(XcpDaq_ListIntegerType daqListNumber, XCP_DAQ_QUEUE_INDEX_TYPE budget) {
+    if (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) {
+        return;
+    }
+    XcpDaq_QueueBudgets[daqListNumber] = budget;
+}
+
+/** @brief Gets the number of queue slots currently occupied by a DAQ list.
+ */
+XCP_DAQ_QUEUE_INDEX_TYPE XcpDaq_GetListQueueUsage(XcpDaq_ListIntegerType daqListNumber) {
+    if (daqListNumber >= (XcpDaq_ListIntegerType)XCP_DAQ_SAMPLING_PLAN_SIZE) {
+        return (XCP_DAQ_QUEUE_INDEX_TYPE)0;
+    }
+    return (XCP_DAQ_QUEUE_INDEX_TYPE)XcpDaq_QueueLoad(XcpDaq_QueueUsage[daqListNumber]);
+}
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+
+/** @brief Publishes a slot previously obtained by XcpDaq_QueueReserve().
+ *
+ *  @param dto  DTO pointer as returned by XcpDaq_QueueReserve().
+ */
     #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data, uint32_t can_id) {
+void XcpDaq_QueueCommit(uint8_t *dto, uint16_t len, uint32_t can_id) {
     #else
-bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data) {
+void XcpDaq_QueueCommit(uint8_t *dto, uint16_t len) {
     #endif
-    if (XcpDaq_QueueFull()) {
-        XcpDaq_Queue.overload = (bool)XCP_TRUE;
-        return (bool)XCP_FALSE;
+    XcpDaq_OdtType *slot = XcpDaq_QueueSlotFromDto(dto);
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_OFF
+    const uint8_t level = (uint8_t)((slot - &XcpDaq_QueueDTOs[0][0]) / XCP_DAQ_PRIORITY_QUEUE_SIZE);
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+
+    slot->len = len;
+    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+    slot->can_id = can_id;
+    #endif
+    /* Slot contents become visible to the consumer together with the new sequence number/head. */
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    XcpDaq_QueueStoreRelease(slot->sequence, XcpDaq_QueueLoad(slot->sequence) + 1UL);
+    #else
+    XcpDaq_QueueStoreRelease(
+        XcpDaq_Queue[level].head,
+        (XcpDaq_QueuePositionType)(XcpDaq_QueueLoad(XcpDaq_Queue[level].head) + (XcpDaq_QueuePositionType)1)
+    );
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    XcpDaq_QueueLeave();
+}
+
+/** @brief Gets the next DTO to transmit without removing it.
+ *
+ *  Strict priority scheduling: the oldest DTO of the highest priority queue that isn't empty,
+ *  so lower priority ODT streams are preempted between two DTOs.
+ *
+ *  @return Pointer to the DTO (with XCP_TRANSPORT_LAYER_BUFFER_OFFSET bytes of headroom,
+ *          see Xcp_SendDtoBuffer()) or XCP_NULL if the queue is empty.
+ *  @note   The DTO stays valid until XcpDaq_QueueRelease() is called.
+ */
+    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+uint8_t *XcpDaq_QueuePeek(uint16_t *len, uint32_t *can_id) {
+    #else
+uint8_t *XcpDaq_QueuePeek(uint16_t *len) {
+    #endif
+    uint8_t         level = UINT8(XCP_DAQ_PRIORITY_QUEUES);
+    XcpDaq_OdtType *slot  = XCP_NULL;
+
+    do {
+        if (level == UINT8(0)) {
+            return XCP_NULL;
+        }
+        --level;
+    } while (!XcpDaq_QueueLevelReady(level));
+    XcpDaq_QueuePeeked = level;
+    slot               = XCP_DAQ_QUEUE_SLOT(level, XcpDaq_QueueLoad(XcpDaq_Queue[level].tail));
+    *len               = slot->len;
+    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+    *can_id = slot->can_id;
+    #endif
+    return &slot->data[XCP_TRANSPORT_LAYER_BUFFER_OFFSET];
+}
+
+    #if XCP_DAQ_TRANSMIT_BATCH_SIZE > 1
+/** @brief Looks behind the DTO returned by XcpDaq_QueuePeek(), within the same priority queue.
+ *
+ *  @param ahead    Distance to the peeked DTO, less than XCP_DAQ_PRIORITY_QUEUE_SIZE.
+ *  @return DTO or XCP_NULL if it isn't ready (yet).
+ *  @note   Consumer side only; the DTOs are removed by calling XcpDaq_QueueRelease() `ahead` + 1 times.
+ */
+XCP_STATIC uint8_t *XcpDaq_QueuePeekAhead(uint16_t ahead, uint16_t *len) {
+    const uint8_t                  level = XcpDaq_QueuePeeked;
+    const XcpDaq_QueuePositionType tail  = XcpDaq_QueueLoad(XcpDaq_Queue[level].tail);
+    const XcpDaq_QueuePositionType pos   = (XcpDaq_QueuePositionType)(tail + (XcpDaq_QueuePositionType)ahead);
+    XcpDaq_OdtType                *slot  = XCP_DAQ_QUEUE_SLOT(level, pos);
+
+        #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    if (XcpDaq_QueueLoadAcquire(slot->sequence) != (XCP_DAQ_QUEUE_LAP(pos) + 1UL)) {
+        return XCP_NULL;
+    }
+        #else
+    if ((XcpDaq_QueuePositionType)(XcpDaq_QueueLoadAcquire(XcpDaq_Queue[level].head) - tail) <=
+        (XcpDaq_QueuePositionType)ahead) {
+        return XCP_NULL;
     }
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    *len = slot->len;
+    return &slot->data[XCP_TRANSPORT_LAYER_BUFFER_OFFSET];
+}
+    #endif /* XCP_DAQ_TRANSMIT_BATCH_SIZE */
+
+/** @brief Removes the DTO returned by XcpDaq_QueuePeek() from the queue.
+ *
+ *  @note Consumer side only.
+ */
+void XcpDaq_QueueRelease(void) {
+    const uint8_t                  level = XcpDaq_QueuePeeked;
+    const XcpDaq_QueuePositionType tail  = XcpDaq_QueueLoad(XcpDaq_Queue[level].tail);
+    XcpDaq_OdtType                *slot  = XCP_DAQ_QUEUE_SLOT(level, tail);
+
+    if (!XcpDaq_QueueLevelReady(level)) {
+        return;
+    }
+    #if XCP_DAQ_ENABLE_QUEUE_BUDGETS == XCP_ON
+    if (slot->owner != XCP_DAQ_NO_LIST) {
+        XcpDaq_QueueDecrement(XcpDaq_QueueUsage[slot->owner]);
+    }
+    #endif /* XCP_DAQ_ENABLE_QUEUE_BUDGETS */
+    #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    XcpDaq_QueueStore(XcpDaq_Queue[level].tail, tail + 1UL);
+    /* Hands the slot back to the producers (for the next lap) after we're done with it. */
+    XcpDaq_QueueStoreRelease(
+        slot->sequence, XCP_DAQ_QUEUE_LAP(tail) + (XcpDaq_QueuePositionType)XCP_DAQ_PRIORITY_QUEUE_SIZE
+    );
+    #else
+    XCP_UNREFERENCED_PARAMETER(slot);
+    /* Hands the slot back to the producer after we're done with it. */
+    XcpDaq_QueueStoreRelease(XcpDaq_Queue[level].tail, (XcpDaq_QueuePositionType)(tail + (XcpDaq_QueuePositionType)1));
+    #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+}
 
-    XcpDaq_QueueDTOs[XcpDaq_Queue.head].len = len;
     #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-    XcpDaq_QueueDTOs[XcpDaq_Queue.head].can_id = can_id;
+bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data, uint32_t can_id) {
+    #else
+bool XcpDaq_QueueEnqueue(uint16_t len, uint8_t const *data) {
     #endif
+    uint8_t *dto = XCP_NULL;
 
     // XCP_ASSERT_LE(len, XCP_MAX_DTO);
     if (len > XCP_MAX_DTO) {
         return (bool)XCP_FALSE;
     }
-
-    XcpUtl_MemCopy(XcpDaq_QueueDTOs[XcpDaq_Queue.head].data, data, len);
-    XcpDaq_Queue.head = (XcpDaq_Queue.head + UINT8(1)) % UINT8(XCP_DAQ_QUEUE_SIZE);
+    dto = XcpDaq_QueueReserve();
+    if (dto == XCP_NULL) {
+        return (bool)XCP_FALSE;
+    }
+    XcpUtl_MemCopy(dto, data, len);
+    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+    XcpDaq_QueueCommit(dto, len, can_id);
+    #else
+    XcpDaq_QueueCommit(dto, len);
+    #endif
     return (bool)XCP_TRUE;
 }
 
@@ -1004,24 +3310,105 @@ bool XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data, uint32_t *can_id) {
     #else
 bool XcpDaq_QueueDequeue(uint16_t *len, uint8_t *data) {
     #endif
-    uint16_t dto_len;
+    uint16_t       dto_len = UINT16(0);
+    uint8_t const *dto     = XCP_NULL;
+    bool           result  = (bool)XCP_FALSE;
 
-    if (XcpDaq_QueueEmpty()) {
+    if (!XcpDaq_QueueClaim()) {
         return (bool)XCP_FALSE;
     }
-    dto_len = XcpDaq_QueueDTOs[XcpDaq_Queue.tail].len;
+    if (XcpDaq_QueueDiscard()) {
+    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
+        dto = XcpDaq_QueuePeek(&dto_len, can_id);
+    #else
+        dto = XcpDaq_QueuePeek(&dto_len);
+    #endif
+    }
     // XCP_ASSERT_LE(dto_len, XCP_MAX_DTO);
-    if (dto_len > XCP_MAX_DTO) {
+    if ((dto != XCP_NULL) && (dto_len <= XCP_MAX_DTO)) {
+        *len = dto_len;
+        XcpUtl_MemCopy(data, dto, dto_len);
+        XcpDaq_QueueRelease();
+        result = (bool)XCP_TRUE;
+    }
+    XcpDaq_QueueUnclaim();
+    return result;
+}
+
+    #if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+/** @brief Records an event occurrence for the DAQ worker.
+ *
+ *  @return XCP_FALSE if the event ring is full.
+ *  @note   Producer side, lock-free like XcpDaq_QueueReserveLevel().
+ */
+XCP_STATIC bool XcpDaq_EventRingPush(uint8_t eventChannelNumber, XcpDaq_TimestampType timestamp) {
+    XcpDaq_QueuePositionType head   = XcpDaq_QueueLoad(XcpDaq_EventRing.head);
+    XcpDaq_EventRecordType  *record = XCP_NULL;
+        #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    int32_t dif = 0;
+
+    XCP_FOREVER {
+        record = XCP_DAQ_EVENT_RECORD(head);
+        dif    = (int32_t)(XcpDaq_QueueLoadAcquire(record->sequence) - XCP_DAQ_EVENT_LAP(head));
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &XcpDaq_EventRing.head, &head, head + 1UL, memory_order_relaxed, memory_order_relaxed
+                )) {
+                break;
+            }
+        } else if (dif < 0) {
+            /* Record of the previous lap wasn't processed yet. */
+            return (bool)XCP_FALSE;
+        } else {
+            head = XcpDaq_QueueLoad(XcpDaq_EventRing.head);
+        }
+    }
+    record->timestamp    = timestamp;
+    record->eventChannel = eventChannelNumber;
+    XcpDaq_QueueStoreRelease(record->sequence, XCP_DAQ_EVENT_LAP(head) + 1UL);
+        #else
+    if ((XcpDaq_QueuePositionType)(head - XcpDaq_QueueLoadAcquire(XcpDaq_EventRing.tail)) >=
+        (XcpDaq_QueuePositionType)XCP_DAQ_QUEUE_SIZE) {
         return (bool)XCP_FALSE;
     }
-    *len = dto_len;
-    #if (XCP_DAQ_ENABLE_PID_OFF == XCP_ON) && (XCP_TRANSPORT_LAYER == XCP_ON_CAN)
-    *can_id = XcpDaq_QueueDTOs[XcpDaq_Queue.tail].can_id;
-    #endif
-    XcpUtl_MemCopy(data, XcpDaq_QueueDTOs[XcpDaq_Queue.tail].data, dto_len);
-    XcpDaq_Queue.tail = (XcpDaq_Queue.tail + UINT8(1)) % UINT8(XCP_DAQ_QUEUE_SIZE);
+    record               = XCP_DAQ_EVENT_RECORD(head);
+    record->timestamp    = timestamp;
+    record->eventChannel = eventChannelNumber;
+    XcpDaq_QueueStoreRelease(XcpDaq_EventRing.head, (XcpDaq_QueuePositionType)(head + 1U));
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    return (bool)XCP_TRUE;
+}
+
+/** @brief Takes the oldest event occurrence off the ring.
+ *
+ *  @return XCP_FALSE if the event ring is empty.
+ */
+XCP_STATIC bool XcpDaq_EventRingPop(uint8_t *eventChannelNumber, XcpDaq_TimestampType *timestamp) {
+    const XcpDaq_QueuePositionType tail   = XcpDaq_QueueLoad(XcpDaq_EventRing.tail);
+    XcpDaq_EventRecordType const  *record = XCP_DAQ_EVENT_RECORD(tail);
+
+        #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    if (XcpDaq_QueueLoadAcquire(record->sequence) != (XCP_DAQ_EVENT_LAP(tail) + 1UL)) {
+        return (bool)XCP_FALSE;
+    }
+        #else
+    if (XcpDaq_QueueLoadAcquire(XcpDaq_EventRing.head) == tail) {
+        return (bool)XCP_FALSE;
+    }
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
+    *eventChannelNumber = record->eventChannel;
+    *timestamp          = record->timestamp;
+        #if XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS == XCP_ON
+    XcpDaq_QueueStoreRelease(
+        XCP_DAQ_EVENT_RECORD(tail)->sequence, XCP_DAQ_EVENT_LAP(tail) + (XcpDaq_QueuePositionType)XCP_DAQ_QUEUE_SIZE
+    );
+    XcpDaq_QueueStore(XcpDaq_EventRing.tail, tail + 1UL);
+        #else
+    XcpDaq_QueueStoreRelease(XcpDaq_EventRing.tail, (XcpDaq_QueuePositionType)(tail + 1U));
+        #endif /* XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS */
     return (bool)XCP_TRUE;
 }
+    #endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
 
 // #endif /* XCP_DAQ_ENABLE_DYNAMIC_LISTS */
 #endif /* XCP_DAQ_ENABLE_QUEUING */
@@ -81,7 +81,7 @@ static XcpTimecorr_StateType XcpTimecorr_State = {
     .grandmaster_source  = XCP_NULL,
 };
 
-/* Built-in XCP slave clock info (uses XcpHw_GetTimerCounter) */
+/* Built-in XCP slave clock info (uses XcpHw_GetTimerCounter / XcpHw_GetTimerCounter64) */
 static const XcpTimecorr_ClockInfoType XcpTimecorr_SlaveClockInfo = {
     .uuid          = XCP_TIMECORR_SLV_UUID,
     .ticks         = UINT16(1),
@@ -442,7 +442,7 @@ static void XcpTimecorr_BuildClockInfoBlock(bool include_grandm, bool include_re
             } else if (XcpTimecorr_State.grandmaster_source->get_timestamp_u64 != XCP_NULL) {
                 grandm_ts = XcpTimecorr_State.grandmaster_source->get_timestamp_u64();
             }
-            slv_ts = (uint64_t)XcpHw_GetTimerCounter();
+            slv_ts = XcpHw_GetTimerCounter64();
             XCP_LEAVE_CRITICAL();
 
             WriteU64LE(p, grandm_ts);   /* Origin (grandmaster timestamp) */
@@ -524,7 +524,7 @@ static void XcpTimecorr_SendTimeSyncInternal(
     if (fmt_xcp_slv == UINT8(1)) {
         slv_ts_32 = XcpHw_GetTimerCounter();
     } else if (fmt_xcp_slv == UINT8(2)) {
-        slv_ts_64 = (uint64_t)XcpHw_GetTimerCounter();
+        slv_ts_64 = XcpHw_GetTimerCounter64();
     }
 
     #if XCP_TIMECORR_GRANDM_CLK > 0
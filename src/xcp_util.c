@@ -24,6 +24,7 @@
  */
 
 /*!!! START-INCLUDE-SECTION !!!*/
+#include "xcp.h"
 #include "xcp_util.h"
 
 #include "xcp_macros.h"
@@ -0,0 +1,42 @@
+/*
+ * BlueParrot XCP
+ *
+ * (C) 2007-2026 by Christoph Schueler <github.com/Christoph2,
+ *                                      cpu12.gems@googlemail.com>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * s. FLOSS-EXCEPTION.txt
+ */
+
+/*
+**  Configuration of the cxcp_eth test extension: same as cxcp, but XCP on Ethernet (src/tl/eth/linuxeth.c),
+**  with DTOs handed to the transport layer in batches.
+*/
+#if !defined(__XCP_TEST_ETH_CONFIG_H)
+    #define __XCP_TEST_ETH_CONFIG_H
+
+    #include "../xcp_config.h"
+
+    #undef XCP_TRANSPORT_LAYER
+    #define XCP_TRANSPORT_LAYER XCP_ON_ETHERNET
+
+    /* UDP or TCP and the port are set by the tests, s. Xcp_Options. */
+    #define XCP_ENABLE_ETH_DISCOVERY    (XCP_OFF)
+    #define XCP_DAQ_TRANSMIT_BATCH_SIZE (8)
+
+#endif /* __XCP_TEST_ETH_CONFIG_H */
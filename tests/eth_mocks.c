@@ -0,0 +1,17 @@
+
+#include <stdio.h>
+
+#include "xcp.h"
+#include "xcp_hw.h"
+#include "xcp_threads.h"
+
+/* Set by the tests before Xcp_Init() (resp. XcpTl_Init()). */
+Xcp_OptionsType Xcp_Options = { 0 };
+
+void XcpHw_ErrorMsg(char * const function, int errorCode) {
+    printf("%s: error %d\n", function, errorCode);
+}
+
+bool XcpThrd_IsShuttingDown(void) {
+    return false;
+}
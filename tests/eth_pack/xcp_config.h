@@ -0,0 +1,37 @@
+/*
+ * BlueParrot XCP
+ *
+ * (C) 2007-2026 by Christoph Schueler <github.com/Christoph2,
+ *                                      cpu12.gems@googlemail.com>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * s. FLOSS-EXCEPTION.txt
+ */
+
+/*
+**  Configuration of the cxcp_eth_pack test extension: same as cxcp_eth, but several DTOs per UDP datagram / TCP write.
+*/
+#if !defined(__XCP_TEST_ETH_PACK_CONFIG_H)
+    #define __XCP_TEST_ETH_PACK_CONFIG_H
+
+    #include "../eth/xcp_config.h"
+
+    #define XCP_ETH_PACKET_SIZE (64)
+    #define XCP_ETH_FLUSH_TIME  (1000)
+
+#endif /* __XCP_TEST_ETH_PACK_CONFIG_H */
@@ -0,0 +1,56 @@
+/*
+ * BlueParrot XCP
+ *
+ * (C) 2007-2025 by Christoph Schueler <github.com/Christoph2,
+ *                                      cpu12.gems@googlemail.com>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * s. FLOSS-EXCEPTION.txt
+ */
+
+/*
+**  Configuration of the cxcp_mp test extension: same as cxcp, but large priority queues that take several producers
+**  and overloads reported by EV_DAQ_OVERLOAD.
+*/
+#if !defined(__XCP_TEST_MP_CONFIG_H)
+    #define __XCP_TEST_MP_CONFIG_H
+
+    #include "../xcp_config.h"
+
+    #define XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS (XCP_ON)
+
+    /* Queue positions beyond uint8_t. */
+    #undef XCP_DAQ_QUEUE_SIZE
+    #define XCP_DAQ_QUEUE_SIZE (1024)
+
+    /* The other overload indication. */
+    #undef XCP_DAQ_OVERLOAD_INDICATION
+    #define XCP_DAQ_OVERLOAD_INDICATION XCP_DAQ_OVERLOAD_INDICATION_EVENT
+
+    /* Four priority queues of 256 DTOs. */
+    #undef XCP_DAQ_ENABLE_PRIORITIZATION
+    #define XCP_DAQ_ENABLE_PRIORITIZATION (XCP_ON)
+
+    /* 64-bit time base. */
+    #undef XCP_DAQ_TIMESTAMP_SIZE
+    #define XCP_DAQ_TIMESTAMP_SIZE (XCP_DAQ_TIMESTAMP_SIZE_8)
+
+    /* Events may be sampled by a DAQ worker. */
+    #define XCP_DAQ_ENABLE_ASYNC_SAMPLING (XCP_ON)
+
+#endif /* __XCP_TEST_MP_CONFIG_H */
@@ -8,6 +8,8 @@ from pprint import pprint
 import random
 import pytest
 
+import cxcp
+
 from hypothesis import (
     assume, event, example, given, infer, note, reject, register_random, reproduce_failure, settings,
     Verbosity, HealthCheck
@@ -25,7 +27,11 @@ from cxcp import (
     get_daq_counts, xcpdaq_total_dynamic_entity_count, xcpdaq_queue_init, xcpdaq_write_entry,
     get_dynamic_daq_entities, get_dynamic_daq_entity,
     daq_enqueue, daq_dequeue, get_daq_queue_var, xcpdaq_set_list_mode, xcpdaq_get_first_pid,
-    xcpdaq_start_stop_single_list, xcpdaq_start_stop_synch,  xcpdaq_trigger_event,
+    xcpdaq_start_stop_single_list, xcpdaq_start_stop_synch,  xcpdaq_trigger_event, xcpdaq_trigger_events,
+    dispatch_command, sent_packets, daq_sent_dtos, xcpdaq_get_plan_statistics, daq_reserve_commit, daq_peek,
+    daq_dequeue_dto, xcpdaq_set_list_queue_budget, xcpdaq_get_list_queue_usage, XCP_DAQ_QUEUE_SIZE,
+    get_list_lost_samples, get_event_lost_samples, xcpdaq_update_begin, xcpdaq_update_end,
+    xcphw_set_timer_counter, get_bypass_statistics,
 )
 
 mem = MemoryInfo()
@@ -34,6 +40,22 @@ mem = MemoryInfo()
 
 XCP_DAQ_MAX_DYNAMIC_ENTITIES = 16
 
+# s. xcp.h / tests/xcp_mocks.c
+XCP_DAQ_LIST_MODE_DIRECTION = 0x02
+XCP_DAQ_LIST_MODE_TIMESTAMP = 0x10
+XCP_DAQ_TIMESTAMP_MODE = 0x34  # 1US, 4 bytes.
+XCP_DAQ_NO_BIT_OFFSET = 0xff
+XCP_DAQ_OVERLOAD_PID_MSB = 0x80
+XCP_DAQ_PROP_OVERLOAD_MSB, XCP_DAQ_PROP_OVERLOAD_EVENT = 0x40, 0x80
+EV_DAQ_OVERLOAD = b"\xfd\x06"
+START_STOP_STOP, START_STOP_START, START_STOP_SELECT = 0, 1, 2
+LISTS_STOP_ALL, LISTS_START_SELECTED = 0, 1
+EVT_100MS, EVT_SPORADIC, EVT_10MS, EVT_BYPASS, EVT_10MS_PRESCALED_3, EVT_SPORADIC_5MS = range(6)
+XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_100US, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS = 5, 6
+ERR_MEMORY_OVERFLOW = b"\xfe\x30"
+ERR_DAQ_ACTIVE = b"\xfe\x11"
+ERR_OUT_OF_RANGE = b"\xfe\x22"
+
 daq_entity_int = integers(min_value = 0, max_value = XCP_DAQ_MAX_DYNAMIC_ENTITIES * 2)
 
 def choose(size):
@@ -220,7 +242,7 @@ def test_daq_queue_empty(xcp):
 
 def test_daq_queue_full(xcp):
     xcpdaq_queue_init()
-    for _ in range(15):
+    for _ in range(16):
         assert daq_enqueue(b"test") == True    # b"test data"
     assert daq_enqueue(b"test") == False
 
@@ -233,6 +255,71 @@ def test_daq_queue_push_pop_seq(xcp):
         assert res == True
         assert data == str(chr(ord('0') + idx) * 8)
 
+def test_daq_queue_in_place(xcp):
+    xcpdaq_queue_init()
+    slot = daq_reserve_commit(b"\x01abc")
+    assert slot != 0
+    assert daq_peek(release = False) == (slot, b"\x01abc")   # Sent straight from the slot it was assembled in.
+    assert daq_peek() == (slot, b"\x01abc")
+    assert daq_peek() == (0, b"")
+
+def test_daq_queue_in_place_full(xcp):
+    xcpdaq_queue_init()
+    slots = [daq_reserve_commit(bytes([idx])) for idx in range(16)]
+    assert 0 not in slots and len(set(slots)) == 16
+    assert daq_reserve_commit(b"\xff") == 0
+    assert daq_peek() == (slots[0], b"\x00")
+    assert daq_reserve_commit(b"\x10") == slots[0]             # The released slot is reused.
+    assert [daq_peek()[1] for _ in range(16)] == [bytes([idx]) for idx in range(1, 17)]
+
+##
+## DTO queue, one and several producers.
+##
+@pytest.fixture(scope = "function", params = ["cxcp", "cxcp_mp"])
+def queue(request):
+    module = pytest.importorskip(request.param)
+    module.xcp_init()
+    module.xcpdaq_init()
+    module.xcpdaq_queue_init()
+    yield module
+    module.xcpdaq_free()
+
+def test_daq_queue_contents_with_wraparound(queue):
+    size = queue.XCP_DAQ_PRIORITY_QUEUE_SIZE
+    for lap in range(size // 5):
+        for idx in range(10):
+            assert queue.daq_enqueue(bytes([lap & 0xff, idx, 0x55])) == True
+        var = queue.get_daq_queue_var()
+        assert var.head == ((lap + 1) * 10) % size
+        assert var.tail == (lap * 10) % size
+        for idx in range(10):
+            assert queue.daq_dequeue_dto() == (True, bytes([lap & 0xff, idx, 0x55]))
+        var = queue.get_daq_queue_var()
+        assert var.head == var.tail == ((lap + 1) * 10) % size
+    assert queue.daq_dequeue_dto() == (False, b"")
+
+def test_daq_queue_full_across_wraparound(queue):
+    size = queue.XCP_DAQ_PRIORITY_QUEUE_SIZE
+    for idx in range(5):
+        queue.daq_enqueue(b"skip")
+        queue.daq_dequeue_dto()
+    for idx in range(size):
+        assert queue.daq_enqueue(idx.to_bytes(2, "little")) == True
+    assert queue.daq_enqueue(b"lost") == False
+    for idx in range(size):
+        assert queue.daq_dequeue_dto() == (True, idx.to_bytes(2, "little"))
+    assert queue.daq_dequeue_dto() == (False, b"")
+
+def test_daq_queue_concurrent_spsc(queue):
+    assert queue.daq_queue_stress(1, 10000) == (10000, 0)
+
+def test_daq_queue_concurrent_mpsc():
+    module = pytest.importorskip("cxcp_mp")
+    module.xcp_init()
+    module.xcpdaq_init()
+    assert module.daq_queue_stress(4, 5000) == (20000, 0)
+    module.xcpdaq_free()
+
 
 def test_complex_sequence_1(xcp):
     mem = MemoryInfo()
@@ -265,6 +352,705 @@ def test_complex_sequence_1(xcp):
         print("="*80)
     print("DYN-Entries:", get_dynamic_daq_entities())
 
+##
+## Sampling plans: compiled at start, plans of running lists stay put, lists being started are appended.
+##
+@pytest.fixture(scope = "function")
+def daq(xcp):
+    dispatch_command(b"\xff\x00")  # CONNECT
+    daq_sent_dtos()
+    yield
+    xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    for list_num in range(XCP_DAQ_MAX_DYNAMIC_ENTITIES):
+        xcpdaq_set_list_queue_budget(list_num, 0)
+
+# Same, for the cxcp_mp variant.
+@pytest.fixture(scope = "function")
+def daq_mp():
+    module = pytest.importorskip("cxcp_mp")
+    module.xcp_init()
+    module.xcpdaq_init()
+    module.dispatch_command(b"\xff\x00")  # CONNECT
+    module.sent_packets()
+    yield module
+    module.xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    for list_num in range(XCP_DAQ_MAX_DYNAMIC_ENTITIES):
+        module.xcpdaq_set_list_queue_budget(list_num, 0)
+    # The event ring survives XcpDaq_Init(), occurrences of stopped lists are dropped.
+    module.xcpdaq_process_events()
+    for event in range(EVT_SPORADIC_5MS + 1):
+        module.xcpdaq_set_async_sampling(event, False)
+    module.set_worker_callout(False)
+    module.xcpdaq_free()
+
+def daq_configure(lists, module = cxcp):
+    """`lists`: per DAQ list, per ODT, the ODT entries as `(bit_offset, size, address)`."""
+    module.xcpdaq_free()
+    assert module.xcpdaq_alloc(len(lists)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        assert module.xcpdaq_alloc_odt(list_num, len(odts)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        for odt_num, entries in enumerate(odts):
+            assert module.xcpdaq_alloc_odt_entry(list_num, odt_num, len(entries)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        for odt_num, entries in enumerate(odts):
+            module.xcpdaq_set_pointer(list_num, odt_num, 0)
+            for bit_offset, size, address in entries:
+                module.xcpdaq_write_entry(bit_offset, size, 0, address)
+
+def daq_entry(variable, size = None):
+    return (XCP_DAQ_NO_BIT_OFFSET, size or ctypes.sizeof(variable), ctypes.addressof(variable))
+
+def daq_start_selected(*lists, module = cxcp):
+    for list_num in lists:
+        module.xcpdaq_start_stop_single_list(list_num, START_STOP_SELECT)
+    module.xcpdaq_start_stop_synch(LISTS_START_SELECTED)
+
+def start_stop_daq_list(list_num, mode):
+    return dispatch_command(bytes([0xde, mode]) + list_num.to_bytes(2, "little"))[2]
+
+def start_stop_synch(mode):
+    return dispatch_command(bytes([0xdd, mode]))[2]
+
+def test_plan_sampling(daq):
+    a, b, c = (ctypes.c_uint32(idx) for idx in (0x11111111, 0x22222222, 0x33333333))
+    daq_configure([
+        [[daq_entry(a), daq_entry(b)], [daq_entry(c)]],
+        [[daq_entry(c), daq_entry(a)]],
+    ])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    xcpdaq_set_list_mode(1, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0, 1)
+    _, pid0 = xcpdaq_get_first_pid(0)
+    _, pid1 = xcpdaq_get_first_pid(1)
+    xcpdaq_trigger_event(EVT_100MS)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos() == [
+        bytes([pid0]) + bytes(a) + bytes(b), bytes([pid0 + 1]) + bytes(c), bytes([pid1]) + bytes(c) + bytes(a)
+    ]
+    a.value = 0x44444444    # The plan refers to the variables, not to their values at start time.
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos() == [bytes([pid1]) + bytes(c) + bytes(a)]
+    xcpdaq_trigger_event(EVT_SPORADIC)
+    assert daq_sent_dtos() == []
+
+def test_plan_overflow(daq):
+    b, a, c = (ctypes.c_uint32(idx) for idx in range(3))
+    daq_configure([
+        [[daq_entry(b)]],
+        [[daq_entry(a)] for _ in range(4)],
+        [[daq_entry(c)]],
+    ])
+    xcpdaq_set_list_mode(0, 0, EVT_10MS, 1, 0)
+    xcpdaq_set_list_mode(1, 0, EVT_SPORADIC, 1, 0)
+    xcpdaq_set_list_mode(2, 0, EVT_100MS, 1, 0)
+    start_stop_daq_list(2, START_STOP_SELECT)
+    assert start_stop_synch(LISTS_START_SELECTED)[0] == 0xff
+    for list_num in (1, 0):
+        assert start_stop_daq_list(list_num, START_STOP_START)[0] == 0xff
+
+    # Restarting lists 1 and 0 in turn appends their plans, until the plan is full.
+    responses = []
+    for _ in range(4):
+        for list_num in (1, 0):
+            assert start_stop_daq_list(list_num, START_STOP_STOP)[0] == 0xff
+            responses.append(start_stop_daq_list(list_num, START_STOP_START))
+    assert ERR_MEMORY_OVERFLOW in responses
+    failed = responses.index(ERR_MEMORY_OVERFLOW)
+    assert all(response[0] == 0xff for response in responses[:failed])
+    assert failed % 2 == 0  # List 1, the one with four ODTs.
+
+    _, pid2 = xcpdaq_get_first_pid(2)
+    daq_sent_dtos()
+    xcpdaq_trigger_event(EVT_SPORADIC)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([pid2]) + bytes(c)]   # List 1 isn't started, list 2 unaffected.
+
+    # Synchronized start is all or none: list 0 fits, list 1 doesn't.
+    assert start_stop_daq_list(0, START_STOP_STOP)[0] == 0xff
+    start_stop_daq_list(0, START_STOP_SELECT)
+    start_stop_daq_list(1, START_STOP_SELECT)
+    assert start_stop_synch(LISTS_START_SELECTED) == ERR_MEMORY_OVERFLOW
+    daq_sent_dtos()
+    xcpdaq_trigger_event(EVT_10MS)
+    xcpdaq_trigger_event(EVT_SPORADIC)
+    assert daq_sent_dtos() == []
+
+    # Once all lists are stopped, the plan starts over.
+    assert start_stop_synch(LISTS_STOP_ALL)[0] == 0xff
+    start_stop_daq_list(0, START_STOP_SELECT)
+    start_stop_daq_list(1, START_STOP_SELECT)
+    assert start_stop_synch(LISTS_START_SELECTED)[0] == 0xff
+    daq_sent_dtos()
+    xcpdaq_trigger_event(EVT_SPORADIC)
+    assert len(daq_sent_dtos()) == 4
+
+##
+## Sampling plans: address-adjacent ODT entries are copied at once.
+##
+def test_plan_coalesced_entries(daq):
+    words, x = (ctypes.c_uint16 * 4)(0x1111, 0x2222, 0x3333, 0x4444), ctypes.c_uint32(0x55555555)
+    word = lambda idx: (XCP_DAQ_NO_BIT_OFFSET, 2, ctypes.addressof(words) + 2 * idx)
+    daq_configure([[
+        [word(0), word(1), word(2), daq_entry(x), word(3)],
+        [word(2), word(3)],
+    ]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0)
+    _, pid = xcpdaq_get_first_pid(0)
+    # Seven entries, four runs: words 0..2, x, word 3 and words 2..3; words 2 and 3 are sampled twice.
+    assert xcpdaq_get_plan_statistics() == (7, 4, 3, 2)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [
+        bytes([pid]) + bytes(words)[0 : 6] + bytes(x) + bytes(words)[6 : 8],
+        bytes([pid + 1]) + bytes(words)[4 : 8],
+    ]
+
+##
+## First PIDs: absolute number of the first ODT of a list, kept up to date by the allocation.
+##
+def test_first_pids(daq):
+    value = ctypes.c_uint32(0x12345678)
+    daq_configure([[[daq_entry(value)]] * 2, [[daq_entry(value)]] * 3, [[daq_entry(value)]]])
+    assert [xcpdaq_get_first_pid(list_num) for list_num in range(4)] == [(True, 0), (True, 2), (True, 5), (False, 0)]
+    xcpdaq_set_list_mode(2, 0, EVT_100MS, 1, 0)
+    assert start_stop_daq_list(2, START_STOP_SELECT)[ : 2] == bytes([0xff, 5])  # The response carries the first PID.
+    xcpdaq_start_stop_synch(LISTS_START_SELECTED)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([5]) + bytes(value)]
+    xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    daq_configure([[[daq_entry(value)]], [[daq_entry(value)]] * 4])
+    assert [xcpdaq_get_first_pid(list_num) for list_num in range(3)] == [(True, 0), (True, 1), (False, 0)]
+
+##
+## Deferred transmission: events only queue DTOs, the transport thread sends them.
+##
+def test_deferred_transmission(daq):
+    value = ctypes.c_uint32(0x11223344)
+    daq_configure([[[daq_entry(value)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0)
+    xcpdaq_trigger_event(EVT_10MS)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos(transmit = False) == []
+    assert daq_sent_dtos() == [b"\x00" + bytes(value)] * 2
+
+##
+## Queue budgets: a list can't occupy more than its share of the DTO queue.
+##
+def test_queue_budget(daq):
+    value0 = ctypes.c_uint32(0x11111111)
+    value1 = ctypes.c_uint32(0x22222222)
+    daq_configure([[[daq_entry(value0)]], [[daq_entry(value1)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    xcpdaq_set_list_mode(1, 0, EVT_SPORADIC, 1, 0)
+    xcpdaq_set_list_queue_budget(0, 4)
+    daq_start_selected(0, 1)
+    for _ in range(6):
+        xcpdaq_trigger_event(EVT_100MS)
+    assert xcpdaq_get_list_queue_usage(0) == 4      # Budget exhausted, ...
+    for _ in range(XCP_DAQ_QUEUE_SIZE):
+        xcpdaq_trigger_event(EVT_SPORADIC)
+    assert xcpdaq_get_list_queue_usage(1) == XCP_DAQ_QUEUE_SIZE - 4    # ... but list 1 still got the rest of the queue.
+    assert daq_sent_dtos() == [b"\x00" + bytes(value0)] * 4 + [b"\x01" + bytes(value1)] * (XCP_DAQ_QUEUE_SIZE - 4)
+    assert xcpdaq_get_list_queue_usage(0) == 0
+    assert xcpdaq_get_list_queue_usage(1) == 0
+
+##
+## Overload: lost samples are counted and indicated to the master.
+##
+def test_overload_pid(daq):
+    value = ctypes.c_uint32(0x12345678)
+    daq_configure([[[daq_entry(value)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    xcpdaq_set_list_queue_budget(0, 4)
+    daq_start_selected(0)
+    assert dispatch_command(b"\xda")[2][1] & XCP_DAQ_PROP_OVERLOAD_MSB    # GET_DAQ_PROCESSOR_INFO
+    for _ in range(6):
+        xcpdaq_trigger_event(EVT_100MS)
+    assert get_list_lost_samples(0) == 2
+    assert get_event_lost_samples(EVT_100MS) == 2
+    assert daq_sent_dtos() == [b"\x00" + bytes(value)] * 4
+    xcpdaq_trigger_event(EVT_100MS)
+    xcpdaq_trigger_event(EVT_100MS)
+    # Only the first DTO after the loss is flagged.
+    assert daq_sent_dtos() == [bytes([XCP_DAQ_OVERLOAD_PID_MSB]) + bytes(value), b"\x00" + bytes(value)]
+
+def test_overload_event(daq_mp):
+    value = ctypes.c_uint32(0x12345678)
+    daq_configure([[[daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_mp.xcpdaq_set_list_queue_budget(0, 4)
+    daq_start_selected(0, module = daq_mp)
+    assert daq_mp.dispatch_command(b"\xda")[2][1] & XCP_DAQ_PROP_OVERLOAD_EVENT
+    daq_mp.sent_packets()
+    for _ in range(6):
+        daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    assert daq_mp.get_list_lost_samples(0) == 2
+    # Reported after the DTOs sampled before the overrun.
+    assert daq_mp.sent_packets() == [b"\x00" + bytes(value)] * 4 + [EV_DAQ_OVERLOAD]
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    assert daq_mp.sent_packets() == [b"\x00" + bytes(value)]
+
+##
+## Priorities: DTOs of higher priority lists are sent first.
+##
+def test_priority_queues(daq_mp):
+    low = ctypes.c_uint32(0x11111111)
+    high = ctypes.c_uint32(0x22222222)
+    daq_configure([[[daq_entry(low)]] * 3, [[daq_entry(high)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_mp.xcpdaq_set_list_mode(1, 0, EVT_10MS, 1, 200)        # Beyond the last queue, shares it.
+    assert daq_mp.dispatch_command(b"\xdf\x00\x01\x00")[2][7] == 200    # GET_DAQ_LIST_MODE keeps the priority.
+    daq_start_selected(0, 1, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    daq_mp.xcpdaq_trigger_event(EVT_10MS)
+    assert daq_mp.sent_packets() == [b"\x03" + bytes(high)] + [bytes([pid]) + bytes(low) for pid in (0, 1, 2)] * 2
+
+##
+## Snapshots: lists of consistent events are captured in one pass, never during an update.
+##
+def test_snapshot_update(daq):
+    values = [ctypes.c_uint32(idx) for idx in range(4)]
+    daq_configure([[[daq_entry(values[0]), daq_entry(values[1])], [daq_entry(values[2]), daq_entry(values[3])]]])
+    xcpdaq_set_list_mode(0, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0)
+    xcpdaq_update_begin()
+    xcpdaq_trigger_event(EVT_10MS)      # Retried, then given up.
+    assert daq_sent_dtos() == []
+    assert get_list_lost_samples(0) == 1
+    assert get_event_lost_samples(EVT_10MS) == 0
+    for value in values:
+        value.value += 0x100
+    xcpdaq_update_end()
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos() == [b"\x00" + bytes(values[0]) + bytes(values[1]), b"\x01" + bytes(values[2]) + bytes(values[3])]
+
+def test_snapshot_too_large(daq):
+    block = (ctypes.c_uint8 * 15)()
+    daq_configure([[[daq_entry(block)]] * 5])       # 75 bytes, the buffer takes 4 * XCP_MAX_DTO.
+    xcpdaq_set_list_mode(0, 0, EVT_10MS, 1, 0)
+    start_stop_daq_list(0, START_STOP_SELECT)
+    assert start_stop_synch(LISTS_START_SELECTED) == ERR_MEMORY_OVERFLOW
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos() == []
+
+##
+## STIM: images are staged on reception and applied, complete, when the event fires.
+##
+def stim(pid, value):
+    dispatch_command(bytes([pid]) + bytes(ctypes.c_uint32(value)))
+
+def stim_image(pid, value):
+    stim(pid, value)
+    stim(pid + 1, value)
+
+def test_stim_apply(daq):
+    a, b = ctypes.c_uint32(0), ctypes.c_uint32(0)
+    daq_configure([[[daq_entry(a)], [daq_entry(b)]]])
+    xcpdaq_set_list_mode(0, XCP_DAQ_LIST_MODE_DIRECTION, EVT_10MS, 1, 0)
+    daq_start_selected(0)
+    stim_image(0, 1)
+    assert (a.value, b.value) == (0, 0)     # Not before the event.
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a.value, b.value) == (1, 1)
+    stim(0, 2)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a.value, b.value) == (1, 1)     # Incomplete images aren't applied, ...
+    stim(1, 2)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a.value, b.value) == (2, 2)     # ... until they are completed.
+    stim_image(0, 3)
+    stim_image(0, 4)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a.value, b.value) == (4, 4)     # The latest complete image wins.
+    a.value = b.value = 0
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a.value, b.value) == (0, 0)     # Applied once.
+    assert daq_sent_dtos() == []
+
+def test_stim_recompile(daq):
+    a0, b0, a1, b1 = (ctypes.c_uint32(0) for _ in range(4))
+    daq_configure([[[daq_entry(a0)], [daq_entry(b0)]], [[daq_entry(a1)], [daq_entry(b1)]]])
+    xcpdaq_set_list_mode(0, XCP_DAQ_LIST_MODE_DIRECTION, EVT_SPORADIC, 1, 0)
+    xcpdaq_set_list_mode(1, XCP_DAQ_LIST_MODE_DIRECTION, EVT_10MS, 1, 0)
+    daq_start_selected(1)
+    _, pid1 = xcpdaq_get_first_pid(1)
+
+    stim_image(pid1, 5)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a1.value, b1.value) == (5, 5)
+
+    # List 0 is started while list 1 is half-way through an image: list 1's plan is left alone.
+    stim(pid1, 6)
+    xcpdaq_set_pointer(0, 1, 0)
+    xcpdaq_write_entry(XCP_DAQ_NO_BIT_OFFSET, 2, 0, ctypes.addressof(b0))
+    xcpdaq_start_stop_single_list(0, START_STOP_START)
+    _, pid0 = xcpdaq_get_first_pid(0)
+    assert xcpdaq_get_first_pid(1) == (True, pid1)
+    stim(pid1 + 1, 6)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a1.value, b1.value) == (6, 6)
+
+    stim(pid0, 1)
+    dispatch_command(bytes([pid0 + 1, 1, 0]))
+    xcpdaq_trigger_event(EVT_SPORADIC)
+    assert (a0.value, b0.value) == (1, 1)
+
+    # Restarting list 0 over and over reuses its space at the end of the plan.
+    for value in range(2, 66):
+        xcpdaq_start_stop_single_list(0, START_STOP_STOP)
+        xcpdaq_start_stop_single_list(0, START_STOP_START)
+        stim(pid0, value)
+        dispatch_command(bytes([pid0 + 1, value, 0]))
+        xcpdaq_trigger_event(EVT_SPORADIC)
+        assert (a0.value, b0.value) == (value, value)
+    stim_image(pid1, 7)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert (a1.value, b1.value) == (7, 7)
+
+##
+## Bypass: a DAQ list goes out, the STIM list answering it is due at the next occurrence of the event.
+##
+def test_bypass_round_trips(daq):
+    x, y = ctypes.c_uint32(0x1234), ctypes.c_uint32(0)
+    daq_configure([[[daq_entry(x)]], [[daq_entry(y)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_BYPASS, 1, 0)
+    xcpdaq_set_list_mode(1, XCP_DAQ_LIST_MODE_DIRECTION, EVT_BYPASS, 1, 0)
+    daq_start_selected(0, 1)
+    _, stim_pid = xcpdaq_get_first_pid(1)
+    for cycle, latency in enumerate((300, 200, None, 500)):
+        xcphw_set_timer_counter(cycle * 1000)
+        xcpdaq_trigger_event(EVT_BYPASS)
+        if latency is not None:
+            xcphw_set_timer_counter(cycle * 1000 + latency)
+            stim(stim_pid, cycle)
+    xcphw_set_timer_counter(4000)
+    xcpdaq_trigger_event(EVT_BYPASS)
+    assert y.value == 3
+    assert len(daq_sent_dtos()) == 5
+    assert get_bypass_statistics(EVT_BYPASS) == (3, 1, 500, 200, 500)
+    assert get_bypass_statistics(EVT_10MS) == (0, 0, 0, 0, 0)
+
+##
+## Rate limits: event prescalers and min. intervals, reported by GET_DAQ_EVENT_INFO; DAQ list prescalers.
+##
+def get_daq_event_info_cycle(event):
+    response = dispatch_command(bytes([0xd7, 0]) + event.to_bytes(2, "little"))[2]
+    return (response[4], response[5])
+
+def test_event_prescaler(daq):
+    value = ctypes.c_uint32(0)
+    daq_configure([[[daq_entry(value)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_10MS_PRESCALED_3, 1, 0)
+    daq_start_selected(0)
+    for idx in range(7):
+        value.value = idx
+        xcpdaq_trigger_event(EVT_10MS_PRESCALED_3)
+    # Every third occurrence is sampled.
+    assert daq_sent_dtos() == [b"\x00" + bytes(ctypes.c_uint32(idx)) for idx in (2, 5)]
+    assert get_daq_event_info_cycle(EVT_10MS_PRESCALED_3) == (30, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS)
+    assert get_daq_event_info_cycle(EVT_10MS) == (10, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS)
+
+def test_event_min_interval(daq):
+    value = ctypes.c_uint32(0)
+    daq_configure([[[daq_entry(value)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_SPORADIC_5MS, 1, 0)
+    daq_start_selected(0)
+    for time_us in (0, 1000, 4999, 5000, 9000, 10000, 10001):
+        value.value = time_us
+        xcphw_set_timer_counter(time_us)
+        xcpdaq_trigger_event(EVT_SPORADIC_5MS)
+    assert daq_sent_dtos() == [b"\x00" + bytes(ctypes.c_uint32(time_us)) for time_us in (0, 5000, 10000)]
+    assert get_daq_event_info_cycle(EVT_SPORADIC_5MS) == (50, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_100US)
+
+def test_list_prescaler(daq):
+    value = ctypes.c_uint32(0)
+    daq_configure([[[daq_entry(value)]], [[daq_entry(value)]]])
+    assert set_daq_list_mode(0, 0, EVT_10MS, 2, 0)[0] == 0xff
+    assert set_daq_list_mode(1, 0, EVT_10MS, 1, 0)[0] == 0xff
+    daq_start_selected(0, 1)
+    for _ in range(4):
+        xcpdaq_trigger_event(EVT_10MS)
+    assert [dto[0] for dto in daq_sent_dtos()] == [1, 0, 1, 1, 0, 1]
+
+##
+## Bit offsets: each bit entry is sampled into a byte of its own (0 or 1).
+##
+def test_bit_offsets(daq):
+    word = ctypes.c_uint32(0xa5000003)
+    address = ctypes.addressof(word)
+    daq_configure([[[(0, 1, address), (1, 1, address), (2, 1, address), (31, 1, address)]]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0)
+    xcpdaq_trigger_event(EVT_100MS)
+    word.value = 0x80000004
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([0, 1, 1, 0, 1]), bytes([0, 0, 0, 1, 1])]
+
+def test_bit_offsets_mixed(daq):
+    flags = (ctypes.c_uint8 * 4)(0x81, 0x00, 0x10, 0xfe)
+    value = ctypes.c_uint16(0x1234)
+    bits = [(bit, 1, ctypes.addressof(flags) + byte) for byte, bit in ((0, 0), (0, 7), (1, 3), (2, 4), (3, 0), (3, 7))]
+    # Byte entries in between the bit entries keep their place in the DTO.
+    daq_configure([[bits[:3] + [daq_entry(value)] + bits[3:]], [bits[3:]]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    xcpdaq_set_list_mode(1, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0, 1)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([0, 1, 1, 0]) + bytes(value) + bytes([1, 0, 1]), bytes([1, 1, 0, 1])]
+
+##
+## Packed mode (USER_CMD vendor extension): entries are filled into as few DTOs as possible.
+##
+def set_daq_packing(list_num, packed):
+    return dispatch_command(bytes([0xf1, 0x01, int(packed), 0]) + list_num.to_bytes(2, "little"))[2]
+
+def get_daq_entry_position(list_num, odt, entry):
+    response = dispatch_command(bytes([0xf1, 0x02, odt, entry]) + list_num.to_bytes(2, "little"))[2]
+    return (response[1], int.from_bytes(response[2 : 4], "little")) if response[0] == 0xff else response
+
+def test_odt_packing(daq):
+    values = [ctypes.c_uint32(0x11111111 * (idx + 1)) for idx in range(4)]
+    daq_configure([[[daq_entry(value)] for value in values]])
+    xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    assert set_daq_packing(0, True)[0] == 0xff
+    assert [get_daq_entry_position(0, odt, 0) for odt in range(4)] == [(0, 1), (0, 5), (0, 9), (1, 1)]
+    daq_start_selected(0)
+    assert set_daq_packing(0, False) == ERR_DAQ_ACTIVE
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [b"\x00" + b"".join(bytes(value) for value in values[:3]), b"\x01" + bytes(values[3])]
+
+    xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    assert set_daq_packing(0, False)[0] == 0xff
+    assert get_daq_entry_position(0, 3, 0) == (3, 1)
+    daq_start_selected(0)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([pid]) + bytes(value) for pid, value in enumerate(values)]
+
+##
+## Timestamps: in every DTO of a list, checked to fit when the list is configured.
+##
+def get_daq_resolution_info_timestamp_mode(module = cxcp):
+    return module.dispatch_command(b"\xd9")[2][5]
+
+def test_timestamp_every_odt(daq):
+    a, b = ctypes.c_uint32(0xaaaaaaaa), ctypes.c_uint32(0xbbbbbbbb)
+    daq_configure([[[daq_entry(a)], [daq_entry(b)]]])
+    assert set_daq_list_mode(0, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_100MS, 1, 0)[0] == 0xff
+    daq_start_selected(0)
+    xcphw_set_timer_counter(0x01020304)
+    xcpdaq_trigger_event(EVT_100MS)
+    timestamp = bytes(ctypes.c_uint32(0x01020304))
+    assert daq_sent_dtos() == [b"\x00" + timestamp + bytes(a), b"\x01" + timestamp + bytes(b)]
+    assert get_daq_resolution_info_timestamp_mode() == XCP_DAQ_TIMESTAMP_MODE
+
+def test_timestamp_doesnt_fit(daq):
+    block = (ctypes.c_uint8 * 12)()
+    daq_configure([[[daq_entry(block)]]])
+    assert set_daq_list_mode(0, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_100MS, 1, 0) == ERR_OUT_OF_RANGE
+    assert set_daq_list_mode(0, 0, EVT_100MS, 1, 0)[0] == 0xff
+
+def test_timestamp_64(daq_mp):
+    value = ctypes.c_uint32(0x55555555)
+    daq_configure([[[daq_entry(value)], [daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_100MS, 1, 0)
+    daq_start_selected(0, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcphw_set_timer_counter(0x0123456789abcdef)
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    # 64-bit time base, DTOs carry its lower four bytes.
+    timestamp = bytes(ctypes.c_uint32(0x89abcdef))
+    assert daq_mp.sent_packets() == [b"\x00" + timestamp + bytes(value), b"\x01" + timestamp + bytes(value)]
+    assert get_daq_resolution_info_timestamp_mode(daq_mp) == XCP_DAQ_TIMESTAMP_MODE
+
+##
+## Latency histograms, read by GET_DAQ_LATENCIES.
+##
+XCP_DAQ_LATENCY_TRANSPORT = 0xff
+XCP_DAQ_LATENCY_BUCKETS = 33
+
+def get_daq_latencies(source, first_bucket = 0):
+    response = dispatch_command(bytes([0xf1, 0x03, source, first_bucket]))[2]
+    if response[0] != 0xff:
+        return response
+    return [int.from_bytes(response[4 + idx * 4 : 8 + idx * 4], "little") for idx in range(response[1])]
+
+# All buckets, a few per CTO.
+def get_daq_latency_histogram(source):
+    buckets = []
+    while len(buckets) < XCP_DAQ_LATENCY_BUCKETS:
+        buckets += get_daq_latencies(source, len(buckets))
+    return buckets
+
+def test_latency_histograms(daq):
+    value = ctypes.c_uint32(0x55555555)
+    daq_configure([[[daq_entry(value)]], [[daq_entry(value)]]])
+    set_daq_list_mode(0, 0, EVT_100MS, 1, 0)
+    set_daq_list_mode(1, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0, 1)
+    sent_packets()
+    xcphw_set_timer_counter(1000)
+    xcpdaq_trigger_event(EVT_100MS)
+    xcphw_set_timer_counter(1060)
+    xcpdaq_trigger_event(EVT_10MS)
+    # Dequeued at 1100: 100 ticks -> bucket 7 (64..127), 40 ticks -> bucket 6 (32..63).
+    xcphw_set_timer_counter(1100)
+    assert len(daq_sent_dtos()) == 2
+    histogram = get_daq_latency_histogram(EVT_100MS)
+    assert histogram[7] == 1 and sum(histogram) == 1
+    histogram = get_daq_latency_histogram(EVT_10MS)
+    assert histogram[6] == 1 and sum(histogram) == 1
+    assert sum(get_daq_latency_histogram(EVT_SPORADIC)) == 0
+    # Sent without the timer moving on.
+    histogram = get_daq_latency_histogram(XCP_DAQ_LATENCY_TRANSPORT)
+    assert histogram[0] == 2 and sum(histogram) == 2
+    xcpdaq_trigger_event(EVT_100MS)
+    daq_sent_dtos()
+    assert get_daq_latency_histogram(EVT_100MS)[ : 8] == [1, 0, 0, 0, 0, 0, 0, 1]
+
+def test_latency_histograms_out_of_range(daq):
+    assert len(get_daq_latency_histogram(XCP_DAQ_LATENCY_TRANSPORT)) == XCP_DAQ_LATENCY_BUCKETS
+    assert get_daq_latencies(XCP_DAQ_LATENCY_TRANSPORT, XCP_DAQ_LATENCY_BUCKETS) == ERR_OUT_OF_RANGE
+    assert get_daq_latencies(EVT_SPORADIC_5MS + 1) == ERR_OUT_OF_RANGE
+
+##
+## Asynchronous sampling: events only recorded by XcpDaq_TriggerEvent(), sampled by the DAQ worker.
+##
+def test_async_sampling(daq_mp):
+    value = ctypes.c_uint32(0x11111111)
+    daq_configure([[[daq_entry(value)]], [[daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_100MS, 1, 0)
+    daq_mp.xcpdaq_set_list_mode(1, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0, 1, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_set_async_sampling(EVT_100MS, True)
+    daq_mp.set_worker_callout(True)
+    daq_mp.xcphw_set_timer_counter(1000)
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    daq_mp.xcpdaq_trigger_event(EVT_10MS)     # Still sampled synchronously.
+    assert daq_mp.sent_packets() == [b"\x01" + bytes(value)]
+    assert daq_mp.set_worker_callout(True) == 1
+    # Sampled by the worker: current data, timestamp of the occurrence.
+    value.value = 0x22222222
+    daq_mp.xcphw_set_timer_counter(2000)
+    assert daq_mp.xcpdaq_process_events()
+    assert daq_mp.sent_packets() == [b"\x00" + bytes(ctypes.c_uint32(1000)) + bytes(value)]
+    assert not daq_mp.xcpdaq_process_events()
+    assert daq_mp.set_worker_callout(False) == 0
+
+def test_async_sampling_dropped_on_stop(daq_mp):
+    value = ctypes.c_uint32(0x11111111)
+    daq_configure([[[daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_set_async_sampling(EVT_100MS, True)
+    daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    daq_mp.xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    assert daq_mp.xcpdaq_process_events()
+    assert daq_mp.sent_packets() == []
+
+def test_async_sampling_ring_full(daq_mp):
+    value = ctypes.c_uint32(0x11111111)
+    daq_configure([[[daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_set_async_sampling(EVT_100MS, True)
+    for _ in range(daq_mp.XCP_DAQ_QUEUE_SIZE + 3):
+        daq_mp.xcpdaq_trigger_event(EVT_100MS)
+    assert daq_mp.get_event_lost_samples(EVT_100MS) == 3
+
+def test_async_sampling_concurrent(daq_mp):
+    # Few enough occurrences for the event ring and the DTO queue: nothing may get lost.
+    producers, count = 4, daq_mp.XCP_DAQ_PRIORITY_QUEUE_SIZE // 4 - 1
+    value = ctypes.c_uint32(0x11111111)
+    daq_configure([[[daq_entry(value)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start_selected(0, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_set_async_sampling(EVT_100MS, True)
+    for _ in range(20):
+        assert daq_mp.daq_async_stress(EVT_100MS, producers, count) == producers * count
+    assert daq_mp.get_list_lost_samples(0) == 0
+    assert daq_mp.get_event_lost_samples(EVT_100MS) == 0
+
+##
+## Several event channels triggered at once.
+##
+def test_trigger_events(daq):
+    a, b = ctypes.c_uint32(0xaaaaaaaa), ctypes.c_uint32(0xbbbbbbbb)
+    daq_configure([[[daq_entry(a)]], [[daq_entry(b)]]])
+    set_daq_list_mode(0, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_100MS, 1, 0)
+    set_daq_list_mode(1, XCP_DAQ_LIST_MODE_TIMESTAMP, EVT_10MS, 1, 0)
+    sent_packets()
+    # Not running.
+    xcpdaq_trigger_events(bytes([EVT_100MS, EVT_10MS]))
+    assert daq_sent_dtos() == []
+    daq_start_selected(0, 1)
+    _, pid0 = xcpdaq_get_first_pid(0)
+    _, pid1 = xcpdaq_get_first_pid(1)
+    xcphw_set_timer_counter(0x1234)
+    # Sampled in the given order, with a common timestamp.
+    xcpdaq_trigger_events(bytes([EVT_10MS, EVT_SPORADIC, EVT_100MS]))
+    timestamp = bytes(ctypes.c_uint32(0x1234))
+    assert daq_sent_dtos() == [bytes([pid1]) + timestamp + bytes(b), bytes([pid0]) + timestamp + bytes(a)]
+    xcpdaq_trigger_events(b"")
+    assert daq_sent_dtos() == []
+
+def test_trigger_events_prescaled(daq):
+    value = ctypes.c_uint32(0x55555555)
+    daq_configure([[[daq_entry(value)]]])
+    set_daq_list_mode(0, 0, EVT_10MS_PRESCALED_3, 1, 0)
+    daq_start_selected(0)
+    sent_packets()
+    for _ in range(3):
+        xcpdaq_trigger_events(bytes([EVT_10MS_PRESCALED_3]))
+    assert daq_sent_dtos() == [b"\x00" + bytes(value)]
+
+def test_trigger_events_async(daq_mp):
+    a, b = ctypes.c_uint32(0xaaaaaaaa), ctypes.c_uint32(0xbbbbbbbb)
+    daq_configure([[[daq_entry(a)]], [[daq_entry(b)]]], daq_mp)
+    daq_mp.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_mp.xcpdaq_set_list_mode(1, 0, EVT_10MS, 1, 0)
+    daq_start_selected(0, 1, module = daq_mp)
+    daq_mp.sent_packets()
+    daq_mp.xcpdaq_set_async_sampling(EVT_100MS, True)
+    daq_mp.xcpdaq_trigger_events(bytes([EVT_100MS, EVT_10MS]))
+    assert daq_mp.sent_packets() == [b"\x01" + bytes(b)]
+    assert daq_mp.xcpdaq_process_events()
+    assert daq_mp.sent_packets() == [b"\x00" + bytes(a)]
+
+##
+## Several DAQ lists per event channel, sampled by descending priority.
+##
+
+def set_daq_list_mode(list_num, mode, event, prescaler, priority):
+    request = bytes([0xe0, mode]) + list_num.to_bytes(2, "little") + event.to_bytes(2, "little") + bytes([prescaler, priority])
+    return dispatch_command(request)[2]
+
+def test_lists_per_event(daq):
+    values = [ctypes.c_uint32(idx) for idx in range(3)]
+    daq_configure([[[daq_entry(value)]] for value in values])
+    for list_num, priority in enumerate((0, 5, 0)):
+        assert set_daq_list_mode(list_num, 0, EVT_100MS, 1, priority)[0] == 0xff
+    daq_start_selected(0, 1, 2)
+    xcpdaq_trigger_event(EVT_100MS)
+    assert daq_sent_dtos() == [bytes([list_num]) + bytes(values[list_num]) for list_num in (1, 0, 2)]
+    assert set_daq_list_mode(1, 0, EVT_10MS, 1, 5) == ERR_DAQ_ACTIVE    # Chains are only edited while stopped.
+
+    # Moved to another event channel, the chain of the previous one closes the gap.
+    xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    assert set_daq_list_mode(1, 0, EVT_10MS, 1, 5)[0] == 0xff
+    assert set_daq_list_mode(2, 0, EVT_100MS, 1, 7)[0] == 0xff
+    daq_start_selected(0, 1, 2)
+    xcpdaq_trigger_event(EVT_100MS)
+    xcpdaq_trigger_event(EVT_10MS)
+    assert daq_sent_dtos() == [bytes([list_num]) + bytes(values[list_num]) for list_num in (2, 0, 1)]
+
 ##
 ## Hypothesis tests.
 ##
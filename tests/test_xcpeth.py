@@ -0,0 +1,435 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""XCP on Ethernet: the real transport layer (src/tl/eth/linuxeth.c) against a master on the loopback interface."""
+
+import ctypes
+import select
+import socket
+import struct
+import threading
+import time
+
+import pytest
+
+cxcp_eth = pytest.importorskip("cxcp_eth")
+
+# s. xcp.h / tests/xcp_mocks.c
+EVT_100MS = 0
+XCP_DAQ_NO_BIT_OFFSET = 0xff
+START_STOP_SELECT = 2
+LISTS_STOP_ALL, LISTS_START_SELECTED = 0, 1
+XCP_DAQ_TRANSMIT_BATCH_SIZE = 8  # s. tests/eth/xcp_config.h
+CONNECT = b"\xff\x00"
+GET_STATUS = b"\xfd"
+
+
+def frame(payload, counter = 0):
+    """XCP on Ethernet message: LEN, CTR (Intel) and the packet."""
+    return struct.pack("<HH", len(payload), counter) + payload
+
+def split_frames(data):
+    """`(counter, packet)` of all messages in a datagram resp. a piece of the TCP stream."""
+    frames = []
+    while data:
+        length, counter = struct.unpack("<HH", data[ : 4])
+        frames.append((counter, data[4 : 4 + length]))
+        data = data[4 + length : ]
+    return frames
+
+
+class Master:
+    """The other end of the connection, talks to the slave of `module`."""
+
+    def __init__(self, module, tcp, port, accepted = True):
+        self.module = module
+        self.tcp = tcp
+        self.address = ("127.0.0.1", port)
+        self.socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM if tcp else socket.SOCK_DGRAM)
+        self.socket.settimeout(5.0)
+        self.pending = b""
+        if tcp:
+            self.socket.connect(self.address)
+            if accepted:
+                assert module.tl_run()  # accept()
+
+    def send(self, data):
+        if self.tcp:
+            self.socket.sendall(data)
+        else:
+            self.socket.sendto(data, self.address)
+
+    def command(self, packet, counter = 0):
+        """Sends a command and lets the slave process it."""
+        self.send(frame(packet, counter))
+        assert self.module.tl_run()
+
+    def receive(self, count):
+        """The next `count` messages as `(counter, packet)`."""
+        frames = []
+        while not self.tcp and (len(frames) < count):
+            frames.extend(split_frames(self.socket.recv(65536)))
+        while self.tcp:
+            # Complete messages only, the rest stays pending.
+            while (len(frames) < count) and (len(self.pending) >= 4):
+                length = struct.unpack("<H", self.pending[ : 2])[0]
+                if len(self.pending) < 4 + length:
+                    break
+                frames.extend(split_frames(self.pending[ : 4 + length]))
+                self.pending = self.pending[4 + length : ]
+            if len(frames) == count:
+                break
+            self.pending += self.socket.recv(65536)
+        assert len(frames) == count
+        return frames
+
+    def idle(self, timeout = 0.05):
+        """Nothing (more) to receive."""
+        return not self.pending and not select.select([self.socket], [], [], timeout)[0]
+
+    def close(self):
+        self.socket.close()
+
+
+def open_slave(module, tcp):
+    port = module.tl_init(tcp)
+    assert port != 0
+    return port
+
+def close_slave(module, *masters):
+    module.xcpdaq_start_stop_synch(LISTS_STOP_ALL)
+    module.xcpdaq_free()
+    for master in masters:
+        master.close()
+    module.tl_deinit()
+
+@pytest.fixture(params = ["udp", "tcp"])
+def master(request):
+    tcp = request.param == "tcp"
+    port = open_slave(cxcp_eth, tcp)
+    master = Master(cxcp_eth, tcp, port)
+    yield master
+    close_slave(cxcp_eth, master)
+
+# Same, for the cxcp_eth_pack variant.
+@pytest.fixture(params = ["udp", "tcp"])
+def packing_master(request):
+    module = pytest.importorskip("cxcp_eth_pack")
+    tcp = request.param == "tcp"
+    port = open_slave(module, tcp)
+    master = Master(module, tcp, port)
+    yield master
+    close_slave(module, master)
+
+def daq_configure(module, lists):
+    """`lists`: per DAQ list, per ODT, the variables to sample."""
+    module.xcpdaq_free()
+    assert module.xcpdaq_alloc(len(lists)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        assert module.xcpdaq_alloc_odt(list_num, len(odts)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        for odt_num, entries in enumerate(odts):
+            assert module.xcpdaq_alloc_odt_entry(list_num, odt_num, len(entries)) == module.Xcp_ReturnType.ERR_SUCCESS
+    for list_num, odts in enumerate(lists):
+        for odt_num, entries in enumerate(odts):
+            module.xcpdaq_set_pointer(list_num, odt_num, 0)
+            for variable in entries:
+                module.xcpdaq_write_entry(XCP_DAQ_NO_BIT_OFFSET, ctypes.sizeof(variable), 0, ctypes.addressof(variable))
+
+def daq_start(module, *lists):
+    for list_num in lists:
+        module.xcpdaq_start_stop_single_list(list_num, START_STOP_SELECT)
+    module.xcpdaq_start_stop_synch(LISTS_START_SELECTED)
+
+def connect(master):
+    master.command(CONNECT)
+    (counter, response), = master.receive(1)
+    assert response[0] == 0xff
+    return counter
+
+##
+## Transport basics: commands and responses, with consecutive counters.
+##
+def test_connect(master):
+    assert connect(master) == 0
+    assert cxcp_eth.tl_connected()
+    master.command(GET_STATUS, 1)
+    (counter, response), = master.receive(1)
+    assert counter == 1
+    assert response[0] == 0xff
+
+##
+## DTOs handed to the transport layer in batches (sendmmsg() resp. one vectored write).
+##
+def test_daq_batches(master):
+    odts = 7
+    values = [ctypes.c_uint32(0x11111111 * (odt + 1)) for odt in range(odts)]
+    counter = connect(master) + 1
+    daq_configure(cxcp_eth, [[[value] for value in values]])
+    cxcp_eth.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start(cxcp_eth, 0)
+    # More DTOs than fit into one batch.
+    cxcp_eth.xcpdaq_trigger_event(EVT_100MS)
+    cxcp_eth.xcpdaq_trigger_event(EVT_100MS)
+    assert odts * 2 > XCP_DAQ_TRANSMIT_BATCH_SIZE
+    cxcp_eth.tl_transmit_dtos()
+    expected = [bytes([pid]) + bytes(value) for pid, value in enumerate(values)] * 2
+    frames = master.receive(len(expected))
+    assert [packet for _, packet in frames] == expected
+    # In order, i.e. with consecutive counters.
+    assert [counter for counter, _ in frames] == list(range(counter, counter + len(expected)))
+    # Responses continue the sequence.
+    master.command(GET_STATUS)
+    (response_counter, _), = master.receive(1)
+    assert response_counter == counter + len(expected)
+
+def test_daq_batches_udp_datagrams():
+    # UDP: one datagram per DTO, even if they were sent with a single syscall.
+    port = open_slave(cxcp_eth, False)
+    master = Master(cxcp_eth, False, port)
+    try:
+        value = ctypes.c_uint16(0x4711)
+        connect(master)
+        daq_configure(cxcp_eth, [[[value]] * 3])
+        cxcp_eth.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+        daq_start(cxcp_eth, 0)
+        cxcp_eth.xcpdaq_trigger_event(EVT_100MS)
+        cxcp_eth.tl_transmit_dtos()
+        datagrams = [master.socket.recv(65536) for _ in range(3)]
+        assert [len(split_frames(datagram)) for datagram in datagrams] == [1, 1, 1]
+    finally:
+        close_slave(cxcp_eth, master)
+
+##
+## Receiving: TCP through a ring buffer, several messages per recv(); UDP one message per datagram.
+##
+def tcp_master():
+    port = open_slave(cxcp_eth, True)
+    return Master(cxcp_eth, True, port)
+
+def test_tcp_pipelined_commands():
+    master = tcp_master()
+    try:
+        connect(master)
+        master.send(b"".join(frame(GET_STATUS, counter) for counter in range(5)))
+        assert cxcp_eth.tl_run()
+        assert [response[0] for _, response in master.receive(5)] == [0xff] * 5
+        assert master.idle()
+    finally:
+        close_slave(cxcp_eth, master)
+
+def test_tcp_split_message():
+    master = tcp_master()
+    try:
+        message = frame(CONNECT)
+        for split in (1, 3, 4, 5):
+            master.send(message[ : split])
+            assert cxcp_eth.tl_run()
+            assert master.idle()
+            master.send(message[split : ])
+            assert cxcp_eth.tl_run()
+            (_, response), = master.receive(1)
+            assert response[0] == 0xff
+    finally:
+        close_slave(cxcp_eth, master)
+
+def test_tcp_ring_wraparound():
+    # Messages of 5 and 6 bytes in chunks of 7, they repeatedly straddle the end of the ring (2 * 20 bytes).
+    master = tcp_master()
+    try:
+        messages = [GET_STATUS if idx % 2 else CONNECT for idx in range(60)]
+        stream = b"".join(frame(message, idx) for idx, message in enumerate(messages))
+        for offset in range(0, len(stream), 7):
+            master.send(stream[offset : offset + 7])
+            assert cxcp_eth.tl_run()
+        responses = master.receive(len(messages))
+        assert [len(response) for _, response in responses] == [6 if idx % 2 else 8 for idx in range(len(messages))]
+        assert master.idle()
+    finally:
+        close_slave(cxcp_eth, master)
+
+def test_tcp_dlc_too_large():
+    master = tcp_master()
+    try:
+        connect(master)
+        master.send(struct.pack("<HH", 0x100, 0) + bytes(8))
+        assert cxcp_eth.tl_run()
+        # Connection released and closed.
+        assert not cxcp_eth.tl_connected()
+        assert master.socket.recv(16) == b""
+    finally:
+        close_slave(cxcp_eth, master)
+
+def test_udp_malformed_datagrams():
+    port = open_slave(cxcp_eth, False)
+    master = Master(cxcp_eth, False, port)
+    try:
+        # Shorter than the header resp. the announced payload: dropped.
+        master.send(b"\x02\x00")
+        assert cxcp_eth.tl_run()
+        master.send(struct.pack("<HH", 2, 0) + b"\xff")
+        assert cxcp_eth.tl_run()
+        assert master.idle()
+        assert connect(master) == 0
+        # Too large: the master is released, the next datagram connects again.
+        master.send(struct.pack("<HH", 0x100, 0) + bytes(0x100))
+        assert cxcp_eth.tl_run()
+        assert not cxcp_eth.tl_connected()
+        assert connect(master) == 1
+        assert cxcp_eth.tl_connected()
+    finally:
+        close_slave(cxcp_eth, master)
+
+##
+## Event loop: one master at a time, wake-ups.
+##
+def test_one_master_at_a_time():
+    port = open_slave(cxcp_eth, True)
+    first = Master(cxcp_eth, True, port)
+    second = Master(cxcp_eth, True, port, accepted = False)
+    try:
+        connect(first)
+        # Waits in the backlog, the listening socket isn't watched meanwhile.
+        second.send(frame(CONNECT))
+        assert not cxcp_eth.tl_run(100)
+        assert second.idle()
+        first.socket.close()
+        assert cxcp_eth.tl_run()  # EOF
+        assert not cxcp_eth.tl_connected()
+        assert cxcp_eth.tl_run()  # accept()
+        assert cxcp_eth.tl_connected()
+        assert cxcp_eth.tl_run()
+        (_, response), = second.receive(1)
+        assert response[0] == 0xff
+    finally:
+        close_slave(cxcp_eth, second)
+
+def test_master_reconnects():
+    port = open_slave(cxcp_eth, True)
+    master = Master(cxcp_eth, True, port)
+    try:
+        connect(master)
+        master.socket.close()
+        assert cxcp_eth.tl_run()
+        master = Master(cxcp_eth, True, port)
+        connect(master)
+    finally:
+        close_slave(cxcp_eth, master)
+
+def test_wakeup(master):
+    cxcp_eth.tl_wakeup()
+    assert cxcp_eth.tl_run(0)
+    assert not cxcp_eth.tl_run(50)
+    # Still serving.
+    connect(master)
+
+##
+## TCP: DTOs written straight from the queue slots, completely even if the master lags behind.
+##
+def test_tcp_burst():
+    port = open_slave(cxcp_eth, True)
+    master = Master(cxcp_eth, True, port)
+    try:
+        counter = connect(master) + 1
+        assert cxcp_eth.tl_set_send_buffer(4096)
+        master.socket.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        variables = [(ctypes.c_uint8 * 8)(*range(odt, odt + 8)) for odt in range(7)]
+        daq_configure(cxcp_eth, [[[variable] for variable in variables]])
+        cxcp_eth.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+        daq_start(cxcp_eth, 0)
+        rounds = 1000
+        expected = [bytes([pid]) + bytes(variable) for pid, variable in enumerate(variables)] * rounds
+        received = []
+
+        def read():
+            time.sleep(0.2)  # Let the socket buffers run full.
+            received.extend(master.receive(len(expected)))
+
+        reader = threading.Thread(target = read)
+        reader.start()
+        for _ in range(rounds):
+            cxcp_eth.xcpdaq_trigger_event(EVT_100MS)
+            cxcp_eth.tl_transmit_dtos()
+        reader.join()
+        assert [packet for _, packet in received] == expected
+        assert [counter for counter, _ in received] == [(counter + idx) & 0xffff for idx in range(len(expected))]
+        assert master.idle()
+        assert cxcp_eth.tl_connected()
+    finally:
+        close_slave(cxcp_eth, master)
+
+##
+## Packing: several DTOs per UDP datagram resp. TCP write, s. tests/eth_pack/xcp_config.h
+##
+XCP_ETH_PACKET_SIZE, XCP_ETH_FLUSH_TIME = 64, 1000
+
+def packed_list(module, odts, size):
+    """A DAQ list of `odts` ODTs of `size` bytes each, i.e. DTOs of 4 + 1 + `size` bytes."""
+    variables = [(ctypes.c_uint8 * size)(*([odt + 1] * size)) for odt in range(odts)]
+    daq_configure(module, [[[variable] for variable in variables]])
+    module.xcpdaq_set_list_mode(0, 0, EVT_100MS, 1, 0)
+    daq_start(module, 0)
+    return [bytes([pid]) + bytes(variable) for pid, variable in enumerate(variables)]
+
+def receive_packed(master, *counts):
+    """Messages of datagrams resp. TCP writes of `counts` messages each, as `(counter, packet)`."""
+    frames = []
+    if master.tcp:
+        # The stream doesn't keep the boundaries.
+        frames = master.receive(sum(counts))
+    else:
+        for count in counts:
+            datagram = split_frames(master.socket.recv(65536))
+            assert len(datagram) == count
+            frames.extend(datagram)
+    assert master.idle()
+    return frames
+
+def test_packing_deadline(packing_master):
+    module = packing_master.module
+    counter = connect(packing_master) + 1
+    expected = packed_list(module, 3, 4)
+    module.xcphw_set_timer_counter(1000000)
+    module.xcpdaq_trigger_event(EVT_100MS)
+    module.tl_transmit_dtos()
+    assert packing_master.idle()
+    # XCP_ETH_FLUSH_TIME us (ticks of the mocked timer) after the first DTO of the packet.
+    module.xcphw_set_timer_counter(1000000 + XCP_ETH_FLUSH_TIME - 1)
+    module.tl_transmit_dtos()
+    assert packing_master.idle()
+    module.xcphw_set_timer_counter(1000000 + XCP_ETH_FLUSH_TIME)
+    module.tl_transmit_dtos()
+    frames = receive_packed(packing_master, 3)
+    assert [packet for _, packet in frames] == expected
+    assert [counter for counter, _ in frames] == list(range(counter, counter + 3))
+
+def test_packing_full_packet(packing_master):
+    module = packing_master.module
+    counter = connect(packing_master) + 1
+    # Messages of 17 bytes, three fit into a packet.
+    expected = packed_list(module, 4, 12)
+    assert 3 * 17 <= XCP_ETH_PACKET_SIZE < 4 * 17
+    module.xcphw_set_timer_counter(1000000)
+    module.xcpdaq_trigger_event(EVT_100MS)
+    module.tl_transmit_dtos()
+    frames = receive_packed(packing_master, 3)
+    # The last one waits for the flush timer, armed again for its packet.
+    assert module.tl_run()
+    frames += receive_packed(packing_master, 1)
+    assert [packet for _, packet in frames] == expected
+    assert [counter for counter, _ in frames] == list(range(counter, counter + 4))
+
+def test_packing_flushed_by_response(packing_master):
+    module = packing_master.module
+    counter = connect(packing_master) + 1
+    expected = packed_list(module, 2, 4)
+    module.xcphw_set_timer_counter(1000000)
+    module.xcpdaq_trigger_event(EVT_100MS)
+    module.tl_transmit_dtos()
+    assert packing_master.idle()
+    # The packed DTOs go first, the counter stays consecutive.
+    packing_master.command(GET_STATUS)
+    frames = receive_packed(packing_master, 2, 1)
+    assert [packet for _, packet in frames[ : 2]] == expected
+    assert frames[2][1][0] == 0xff
+    assert [counter for counter, _ in frames] == list(range(counter, counter + 3))
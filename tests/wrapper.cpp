@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <variant>
 #include <vector>
@@ -13,12 +16,28 @@
 extern "C" {
 #include "xcp.h"
 
-    char*    data_start();
-    char*    data_end();
+    char*    mock_data_start();
+    char*    mock_data_end();
     uint16_t XcpTl_GetLastSend(uint8_t* buf, uint16_t max_len);
     void     XcpTl_ResetLastSend(void);
+    void     XcpHw_SetTimerCounter(uint64_t value);
+    void     XcpTl_ResetSent(void);
+    uint16_t XcpTl_GetSentCount(void);
+    uint16_t XcpTl_GetSent(uint16_t idx, uint8_t* buf, uint16_t max_len);
+
+#if XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET
+    #include "xcp_eth.h"
+
+    extern Xcp_OptionsType      Xcp_Options;
+    extern XcpTl_ConnectionType XcpTl_Connection;
+#endif /* XCP_TRANSPORT_LAYER */
 }
 
+/* Same wrapper for all test extensions, they differ only in xcp_config.h. */
+#if !defined(XCP_TEST_MODULE)
+    #define XCP_TEST_MODULE cxcp
+#endif /* XCP_TEST_MODULE */
+
 namespace py = pybind11;
 
 struct Mta {
@@ -80,13 +99,14 @@ auto get_daq_counts() -> std::tuple<std::uint8_t, std::uint8_t, std::uint8_t> {
     return { entityCount, listCount, odtCount };
 }
 
-DaqEntity create_daq_entity(const XcpDaq_EntityType& entity) {
+DaqEntity create_daq_entity(const XcpDaq_EntityType& entity, std::uint16_t idx) {
     DaqEntity result{};
 
     auto disc = static_cast<XcpDaq_EntityKindType>(entity.kind);
     switch (disc) {
         case XCP_ENTITY_DAQ_LIST:
-            result = DaqList(entity.entity.daqList.numOdts, entity.entity.daqList.firstOdt, entity.entity.daqList.mode, 0, 0);
+            /* DAQ lists are the first entities, i.e. the entity index is the list number. */
+            result = DaqList(entity.entity.daqList.numOdts, entity.entity.daqList.firstOdt, XcpDaq_GetListState(idx)->mode, 0, 0);
             break;
         case XCP_ENTITY_ODT:
             result = Odt(entity.entity.odt.numOdtEntries, entity.entity.odt.firstOdtEntry);
@@ -99,7 +119,7 @@ DaqEntity create_daq_entity(const XcpDaq_EntityType& entity) {
 }
 
 auto get_dynamic_daq_entity(std::uint16_t idx) -> DaqEntity {
-    return create_daq_entity(*(XcpDaq_GetDynamicEntity(idx)));
+    return create_daq_entity(*(XcpDaq_GetDynamicEntity(idx)), idx);
 }
 
 auto get_dynamic_daq_entities() -> std::vector<DaqEntity> {
@@ -128,6 +148,204 @@ auto daq_dequeue() -> std::tuple<bool, std::string> {
     return std::make_tuple(return_code, std::move(std::string(reinterpret_cast<const char*>(data), length)));
 }
 
+auto daq_dequeue_dto() -> std::tuple<bool, py::bytes> {
+    std::uint16_t length = 0;
+    uint8_t       data[XCP_MAX_DTO];
+
+    if (!XcpDaq_QueueDequeue(&length, &data[0])) {
+        return std::make_tuple(false, py::bytes());
+    }
+    return std::make_tuple(true, py::bytes(reinterpret_cast<const char*>(data), length));
+}
+
+/*
+ * Hammers the DTO queue from `producers` threads (one, unless XCP_DAQ_ENABLE_MULTIPLE_PRODUCERS), while the calling thread consumes.
+ * Each DTO carries its producer and a sequence number.
+ * Returns the number of DTOs received and how many of them were out of order (lost, duplicated or garbled).
+ */
+auto daq_queue_stress(std::uint32_t producers, std::uint32_t count) -> std::tuple<std::uint32_t, std::uint32_t> {
+    std::vector<std::thread>   threads;
+    std::vector<std::uint32_t> expected(producers, 0);
+    std::uint32_t              received = 0;
+    std::uint32_t              errors   = 0;
+
+    py::gil_scoped_release release;
+
+    XcpDaq_QueueInit();
+    for (std::uint32_t id = 0; id < producers; ++id) {
+        threads.emplace_back([id, count] {
+            std::array<std::uint8_t, 8> dto{};
+
+            for (std::uint32_t seq = 0; seq < count;) {
+                std::memcpy(&dto[0], &id, sizeof(id));
+                std::memcpy(&dto[4], &seq, sizeof(seq));
+                if (XcpDaq_QueueEnqueue(static_cast<uint16_t>(dto.size()), dto.data())) {
+                    ++seq;
+                } else {
+                    std::this_thread::yield(); /* Full, let the consumer run. */
+                }
+            }
+        });
+    }
+    while (received < (producers * count)) {
+        std::uint16_t length = 0;
+        uint8_t       data[XCP_MAX_DTO];
+        std::uint32_t id  = 0;
+        std::uint32_t seq = 0;
+
+        if (!XcpDaq_QueueDequeue(&length, &data[0])) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(&id, &data[0], sizeof(id));
+        std::memcpy(&seq, &data[4], sizeof(seq));
+        if ((length != 8) || (id >= producers) || (seq != expected[id])) {
+            ++errors;
+        } else {
+            ++expected[id];
+        }
+        ++received;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::make_tuple(received, errors);
+}
+
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+static std::uint32_t worker_wakeups = 0;
+
+void count_worker_wakeup() {
+    ++worker_wakeups;
+}
+
+/* Counts the calls of the DAQ worker callout (reset by each call of this function). */
+auto set_worker_callout(bool install) -> std::uint32_t {
+    const std::uint32_t wakeups = worker_wakeups;
+
+    XcpDaq_SetWorkerCallout(install ? &count_worker_wakeup : nullptr);
+    worker_wakeups = 0;
+    return wakeups;
+}
+
+/*
+ * `producers` threads trigger `event` `count` times each, while a DAQ worker samples them.
+ * Returns the number of DTOs queued by the worker, the queue is drained.
+ */
+auto daq_async_stress(std::uint8_t event, std::uint32_t producers, std::uint32_t count) -> std::uint32_t {
+    std::vector<std::thread> threads;
+    std::atomic<bool>        done{ false };
+    std::uint32_t            received = 0;
+    std::uint16_t            length   = 0;
+    uint8_t                  data[XCP_MAX_DTO];
+
+    py::gil_scoped_release release;
+
+    std::thread worker([&done] {
+        while (!done.load()) {
+            if (!XcpDaq_ProcessEvents()) {
+                std::this_thread::yield();
+            }
+        }
+        XcpDaq_ProcessEvents();
+    });
+    for (std::uint32_t id = 0; id < producers; ++id) {
+        threads.emplace_back([event, count] {
+            for (std::uint32_t idx = 0; idx < count; ++idx) {
+                XcpDaq_TriggerEvent(event);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.store(true);
+    worker.join();
+    while (XcpDaq_QueueDequeue(&length, &data[0])) {
+        ++received;
+    }
+    return received;
+}
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
+
+/* XcpDaq_TriggerEvents() with the event channel numbers as bytes. */
+void xcpdaq_trigger_events(const std::string& events) {
+    XcpDaq_TriggerEvents(reinterpret_cast<const std::uint8_t*>(events.data()), static_cast<std::uint8_t>(events.size()));
+}
+
+#if XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET
+/* Initializes XCP on a TCP or UDP socket (port 0: any free one), returns the port actually bound. */
+auto tl_init(bool tcp, std::uint16_t port) -> std::uint16_t {
+    struct sockaddr_in address;
+    socklen_t          length = sizeof(address);
+
+    Xcp_Options.tcp  = tcp;
+    Xcp_Options.ipv6 = false;
+    Xcp_Options.port = port;
+    Xcp_Init();
+    if (getsockname(XcpTl_Connection.boundSocket, reinterpret_cast<struct sockaddr*>(&address), &length) == -1) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+/* One turn of the event loop (XcpTl_MainFunction()), if something happens within `timeout` ms; false otherwise. */
+auto tl_run(int timeout) -> bool {
+    struct epoll_event event;
+
+    py::gil_scoped_release release;
+
+    if (epoll_wait(XcpTl_Connection.pollFd, &event, 1, timeout) < 1) {
+        return false;
+    }
+    XcpTl_MainFunction();
+    return true;
+}
+
+/* XcpDaq_TransmitDtos(), the master may read in another Python thread meanwhile. */
+void tl_transmit_dtos() {
+    py::gil_scoped_release release;
+
+    XcpDaq_TransmitDtos();
+}
+
+auto tl_connected() -> bool {
+    return XcpTl_Connection.connected;
+}
+
+/* Shrinks the send buffer of the TCP connection, i.e. writes block as soon as the master lags behind. */
+auto tl_set_send_buffer(int size) -> bool {
+    return setsockopt(XcpTl_Connection.connectedSocket, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) == 0;
+}
+#endif /* XCP_TRANSPORT_LAYER */
+
+/* Assembles a DTO in place: reserves a queue slot, writes it and commits. Returns the slot address (0 if full). */
+auto daq_reserve_commit(const std::string& data) -> std::size_t {
+    uint8_t* dto = XcpDaq_QueueReserve();
+
+    if (dto == nullptr) {
+        return 0;
+    }
+    std::memcpy(dto, data.data(), data.size());
+    XcpDaq_QueueCommit(dto, static_cast<uint16_t>(data.size()));
+    return reinterpret_cast<std::size_t>(dto);
+}
+
+/* Oldest DTO as the transport layer sees it, `(slot address, payload)`; released if `release`. */
+auto daq_peek(bool release) -> std::tuple<std::size_t, py::bytes> {
+    std::uint16_t  length = 0;
+    const uint8_t* dto    = XcpDaq_QueuePeek(&length);
+
+    if (dto == nullptr) {
+        return std::make_tuple(std::size_t{ 0 }, py::bytes());
+    }
+    py::bytes payload(reinterpret_cast<const char*>(dto), length);
+    if (release) {
+        XcpDaq_QueueRelease();
+    }
+    return std::make_tuple(reinterpret_cast<std::size_t>(dto), payload);
+}
+
 void xcp_set_mta_ptr(std::size_t address, std::uint8_t ext) {
     Xcp_MtaType mta = { 0 };
     mta.ext         = ext;
@@ -135,16 +353,9 @@ void xcp_set_mta_ptr(std::size_t address, std::uint8_t ext) {
     Xcp_SetMta(mta);
 }
 
-auto dispatch_command(py::bytes request) -> std::tuple<std::uint16_t, std::uint16_t, py::bytes> {
-    const std::string         request_bytes = request;
-    std::vector<std::uint8_t> request_vec(request_bytes.begin(), request_bytes.end());
-    Xcp_PduType               pdu{ static_cast<uint16_t>(request_vec.size()), request_vec.data() };
-    std::array<uint8_t, 256>  buffer{};
-
-    XcpTl_ResetLastSend();
-    Xcp_DispatchCommand(&pdu);
-
-    const auto            captured_len   = XcpTl_GetLastSend(buffer.data(), static_cast<uint16_t>(buffer.size()));
+/* Splits a frame into length, counter and payload. */
+auto split_frame(const std::array<uint8_t, 256>& buffer, std::uint16_t captured_len)
+    -> std::tuple<std::uint16_t, std::uint16_t, py::bytes> {
     constexpr std::size_t payload_offset = XCP_TRANSPORT_LAYER_BUFFER_OFFSET;
 
     if (captured_len < payload_offset) {
@@ -176,9 +387,93 @@ auto dispatch_command(py::bytes request) -> std::tuple<std::uint16_t, std::uint1
     );
 }
 
+auto dispatch_command(py::bytes request) -> std::tuple<std::uint16_t, std::uint16_t, py::bytes> {
+    const std::string         request_bytes = request;
+    std::vector<std::uint8_t> request_vec(request_bytes.begin(), request_bytes.end());
+    Xcp_PduType               pdu{ static_cast<uint16_t>(request_vec.size()), request_vec.data() };
+    std::array<uint8_t, 256>  buffer{};
+
+    XcpTl_ResetLastSend();
+    Xcp_DispatchCommand(&pdu);
+    return split_frame(buffer, XcpTl_GetLastSend(buffer.data(), static_cast<uint16_t>(buffer.size())));
+}
+
+/*
+ * Payloads of the packets sent since the last call.
+ * With deferred transmission, the queued DTOs are sent first (unless `transmit` is false).
+ */
+auto sent_packets(bool transmit) -> std::vector<py::bytes> {
+    std::vector<py::bytes>   packets;
+    std::array<uint8_t, 256> buffer{};
+
+#if XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION == XCP_ON
+    if (transmit) {
+        XcpDaq_TransmitDtos();
+    }
+#else
+    (void)transmit;
+#endif /* XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION */
+    for (std::uint16_t idx = 0; idx < XcpTl_GetSentCount(); ++idx) {
+        auto [length, counter, payload] =
+            split_frame(buffer, XcpTl_GetSent(idx, buffer.data(), static_cast<uint16_t>(buffer.size())));
+        packets.push_back(payload);
+    }
+    XcpTl_ResetSent();
+    return packets;
+}
+
+/*
+ * Same as sent_packets(), but only the DTOs. Responses, events and service requests
+ * (PIDs 0xfc..0xff) are skipped, DAQ PIDs are below them.
+ */
+auto daq_sent_dtos(bool transmit) -> std::vector<py::bytes> {
+    std::vector<py::bytes> dtos;
+
+    for (const auto& payload : sent_packets(transmit)) {
+        const std::string bytes = payload;
+
+        if (!bytes.empty() && (static_cast<std::uint8_t>(bytes[0]) < 0xfc)) {
+            dtos.push_back(payload);
+        }
+    }
+    return dtos;
+}
+
+auto get_list_lost_samples(XcpDaq_ListIntegerType list) -> std::uint32_t {
+    return XcpDaq_ListLostSamples[list];
+}
+
+auto get_event_lost_samples(std::uint16_t event) -> std::uint32_t {
+    return XcpDaq_EventLostSamples[event];
+}
+
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+/* (cycles, missedDeadlines, latency, minLatency, maxLatency) */
+auto get_bypass_statistics(std::uint16_t event)
+    -> std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t> {
+    const auto& stats = XcpDaq_BypassStatistics[event];
+
+    return std::make_tuple(stats.cycles, stats.missedDeadlines, stats.latency, stats.minLatency, stats.maxLatency);
+}
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+
+auto xcpdaq_get_first_pid(XcpDaq_ListIntegerType list) -> std::tuple<bool, XcpDaq_ODTIntegerType> {
+    XcpDaq_ODTIntegerType pid = 0;
+    const bool            ok  = XcpDaq_GetFirstPid(list, &pid);
+
+    return std::make_tuple(ok, pid);
+}
+
+auto xcpdaq_get_plan_statistics() -> std::tuple<std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t> {
+    XcpDaq_PlanStatisticsType statistics;
+
+    XcpDaq_GetPlanStatistics(&statistics);
+    return std::make_tuple(statistics.entries, statistics.runs, statistics.copiesEliminated, statistics.duplicateEntries);
+}
+
 struct QueueInfo {
-    std::uint16_t head;
-    std::uint16_t tail;
+    std::uint32_t head;
+    std::uint32_t tail;
     bool          overload;
 
     std::string to_string() const {
@@ -196,7 +491,7 @@ auto get_daq_queue_var() -> QueueInfo {
 
 struct MemoryInfo {
     explicit MemoryInfo() {
-        size = data_start() - data_end() - 4;
+        size = mock_data_start() - mock_data_end() - 4;
         printf("Memory: %u bytes\n", size);
     }
 
@@ -208,7 +503,7 @@ struct MemoryInfo {
     }
 
     std::size_t absolute_address(std::size_t offset) const noexcept {
-        return reinterpret_cast<std::size_t>(data_start()) + offset - 4;
+        return reinterpret_cast<std::size_t>(mock_data_start()) + offset - 4;
     }
 
     std::uint8_t as_uint8(std::size_t offset) const noexcept {
@@ -222,7 +517,10 @@ struct MemoryInfo {
     std::uint32_t size;
 };
 
-PYBIND11_MODULE(cxcp, m) {
+PYBIND11_MODULE(XCP_TEST_MODULE, m) {
+    m.attr("XCP_DAQ_QUEUE_SIZE")          = XCP_DAQ_QUEUE_SIZE;
+    m.attr("XCP_DAQ_PRIORITY_QUEUE_SIZE") = XCP_DAQ_PRIORITY_QUEUE_SIZE;
+
     m.def("xcp_init", &Xcp_Init);
     m.def("xcpdaq_init", &XcpDaq_Init);
     m.def("xcpdaq_free", &XcpDaq_Free);
@@ -233,14 +531,49 @@ PYBIND11_MODULE(cxcp, m) {
     m.def("xcpdaq_alloc_odt_entry", &XcpDaq_AllocOdtEntry);
     m.def("xcpdaq_queue_init", &XcpDaq_QueueInit);
     m.def("xcpdaq_set_list_mode", &XcpDaq_SetListMode);
-    m.def("xcpdaq_get_first_pid", &XcpDaq_GetFirstPid);
+    m.def("xcpdaq_get_first_pid", &xcpdaq_get_first_pid);
+    m.def("xcpdaq_get_plan_statistics", &xcpdaq_get_plan_statistics);
     m.def("xcpdaq_start_stop_single_list", &XcpDaq_StartStopSingleList);
     m.def("xcpdaq_start_stop_synch", &XcpDaq_StartStopSynch);
     m.def("xcpdaq_trigger_event", &XcpDaq_TriggerEvent);
+    m.def("xcpdaq_trigger_events", &xcpdaq_trigger_events);
     m.def("daq_enqueue", &daq_enqueue);
     m.def("daq_dequeue", &daq_dequeue);
+    m.def("daq_dequeue_dto", &daq_dequeue_dto);
+    m.def("xcpdaq_set_list_queue_budget", &XcpDaq_SetListQueueBudget);
+    m.def("xcpdaq_get_list_queue_usage", &XcpDaq_GetListQueueUsage);
+    m.def("daq_queue_stress", &daq_queue_stress);
+    m.def("daq_reserve_commit", &daq_reserve_commit);
+    m.def("daq_peek", &daq_peek, py::arg("release") = true);
     m.def("dispatch_command", &dispatch_command);
+    m.def("sent_packets", &sent_packets, py::arg("transmit") = true);
+    m.def("daq_sent_dtos", &daq_sent_dtos, py::arg("transmit") = true);
+    m.def("get_list_lost_samples", &get_list_lost_samples);
+    m.def("xcphw_set_timer_counter", &XcpHw_SetTimerCounter);
+#if XCP_DAQ_ENABLE_BYPASS == XCP_ON
+    m.def("get_bypass_statistics", &get_bypass_statistics);
+#endif /* XCP_DAQ_ENABLE_BYPASS */
+#if XCP_DAQ_ENABLE_SNAPSHOTS == XCP_ON
+    m.def("xcpdaq_update_begin", &XcpDaq_UpdateBegin);
+    m.def("xcpdaq_update_end", &XcpDaq_UpdateEnd);
+#endif /* XCP_DAQ_ENABLE_SNAPSHOTS */
+    m.def("get_event_lost_samples", &get_event_lost_samples);
+#if XCP_DAQ_ENABLE_ASYNC_SAMPLING == XCP_ON
+    m.def("xcpdaq_set_async_sampling", &XcpDaq_SetAsyncSampling);
+    m.def("xcpdaq_process_events", &XcpDaq_ProcessEvents);
+    m.def("set_worker_callout", &set_worker_callout);
+    m.def("daq_async_stress", &daq_async_stress);
+#endif /* XCP_DAQ_ENABLE_ASYNC_SAMPLING */
     m.def("xcp_set_mta", &xcp_set_mta_ptr, py::arg("address"), py::arg("ext") = 0);
+#if XCP_TRANSPORT_LAYER == XCP_ON_ETHERNET
+    m.def("tl_init", &tl_init, py::arg("tcp"), py::arg("port") = 0);
+    m.def("tl_deinit", &XcpTl_DeInit);
+    m.def("tl_run", &tl_run, py::arg("timeout") = 1000);
+    m.def("tl_transmit_dtos", &tl_transmit_dtos);
+    m.def("tl_connected", &tl_connected);
+    m.def("tl_set_send_buffer", &tl_set_send_buffer);
+    m.def("tl_wakeup", &XcpTl_Wakeup);
+#endif /* XCP_TRANSPORT_LAYER */
 
     m.def("Xcp_GetConnectionState", &Xcp_GetConnectionState);
     m.def("Xcp_CalculateChecksum", &Xcp_CalculateChecksum);  // , py::return_value_policy::move
@@ -0,0 +1,63 @@
+/*
+ * BlueParrot XCP
+ *
+ * (C) 2007-2025 by Christoph Schueler <github.com/Christoph2,
+ *                                      cpu12.gems@googlemail.com>
+ *
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * s. FLOSS-EXCEPTION.txt
+ */
+
+/*
+**  Configuration of the test extensions: the Arduino configuration plus the DAQ features under test.
+*/
+#if !defined(__XCP_TEST_CONFIG_H)
+    #define __XCP_TEST_CONFIG_H
+
+    #include "../tools/xcp_config.h"
+
+    #undef XCP_ENABLE_STIM
+    #define XCP_ENABLE_STIM (XCP_ON)
+    #undef XCP_PROTECT_STIM
+    #define XCP_PROTECT_STIM (XCP_OFF)
+
+    #undef XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT
+    #define XCP_DAQ_ENABLE_MULTIPLE_DAQ_LISTS_PER_EVENT (XCP_ON)
+    /* Adds "EVT bypass" and the rate limited events to the events of tests/xcp_mocks.c */
+    #undef XCP_DAQ_MAX_EVENT_CHANNEL
+    #define XCP_DAQ_MAX_EVENT_CHANNEL (6)
+    #undef XCP_DAQ_ENABLE_PRESCALER
+    #define XCP_DAQ_ENABLE_PRESCALER (XCP_ON)
+    #undef XCP_DAQ_ENABLE_BIT_OFFSET
+    #define XCP_DAQ_ENABLE_BIT_OFFSET (XCP_ON)
+    /* Vendor commands, e.g. SET_DAQ_PACKING. */
+    #undef XCP_ENABLE_USER_CMD
+    #define XCP_ENABLE_USER_CMD (XCP_ON)
+
+    /* DTOs stay queued until XcpDaq_TransmitDtos(), so the tests can inspect them. */
+    #define XCP_DAQ_ENABLE_DEFERRED_TRANSMISSION (XCP_ON)
+    #define XCP_DAQ_ENABLE_QUEUE_BUDGETS         (XCP_ON)
+    #define XCP_DAQ_OVERLOAD_INDICATION          XCP_DAQ_OVERLOAD_INDICATION_PID
+    #define XCP_DAQ_ENABLE_SNAPSHOTS             (XCP_ON)
+    #define XCP_DAQ_ENABLE_BYPASS                (XCP_ON)
+    #define XCP_DAQ_ENABLE_EVENT_RATE_LIMITS     (XCP_ON)
+    #define XCP_DAQ_ENABLE_ODT_PACKING           (XCP_ON)
+    #define XCP_DAQ_ENABLE_TIMESTAMP_EVERY_ODT   (XCP_ON)
+    #define XCP_DAQ_ENABLE_LATENCY_HISTOGRAMS    (XCP_ON)
+
+#endif /* __XCP_TEST_CONFIG_H */
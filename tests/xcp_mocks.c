@@ -21,6 +21,13 @@ uint32_t end_marker;
 static uint8_t  last_send[256];
 static uint16_t last_send_len;
 
+/* Everything sent since XcpTl_ResetSent(), for the tests to pick up the DTOs. */
+#define MOCK_SENT_FRAMES (64)
+
+static uint8_t  sent_frames[MOCK_SENT_FRAMES][256];
+static uint16_t sent_lens[MOCK_SENT_FRAMES];
+static uint16_t sent_count;
+
 #if 0
 typedef struct {
     uint8_t value;
@@ -58,15 +65,44 @@ XCP_DAQ_DEFINE_EVENT(
     XCP_DAQ_DEFINE_EVENT(
         "EVT 10ms", XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ | XCP_DAQ_CONSISTENCY_DAQ_LIST, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS, 10
     ),
+#if XCP_DAQ_MAX_EVENT_CHANNEL > 3
+    /* Test configuration, s. tests/xcp_config.h */
+    XCP_DAQ_DEFINE_EVENT(
+        "EVT bypass", XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ_STIM | XCP_DAQ_CONSISTENCY_DAQ_LIST, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS, 1
+    ),
+#endif /* XCP_DAQ_MAX_EVENT_CHANNEL */
+#if XCP_DAQ_MAX_EVENT_CHANNEL > 4
+    XCP_DAQ_DEFINE_RATE_LIMITED_EVENT(
+        "EVT 10ms / 3", XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ | XCP_DAQ_CONSISTENCY_DAQ_LIST, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS, 10, 3, 0
+    ),
+    XCP_DAQ_DEFINE_RATE_LIMITED_EVENT(
+        "EVT sporadic >= 5ms", XCP_DAQ_EVENT_CHANNEL_TYPE_DAQ | XCP_DAQ_CONSISTENCY_DAQ_LIST, XCP_DAQ_EVENT_CHANNEL_TIME_UNIT_1MS, 0,
+        1, 5000
+    ),
+#endif /* XCP_DAQ_MAX_EVENT_CHANNEL */
     XCP_DAQ_END_EVENTS
 
-    uint32_t XcpHw_GetTimerCounter() {
+/* Set by the tests, s. XcpHw_SetTimerCounter(). */
+static uint64_t timer_counter = 0xaaaa;
+
+uint32_t XcpHw_GetTimerCounter() {
     //    return clock();
-    return 0xaaaa;
+    return (uint32_t)timer_counter;
+}
+
+uint64_t XcpHw_GetTimerCounter64(void) {
+    return timer_counter;
 }
 
+void XcpHw_SetTimerCounter(uint64_t value) {
+    timer_counter = value;
+}
+
+#if XCP_TRANSPORT_LAYER != XCP_ON_ETHERNET
+/* Ethernet: the real transport layer, s. src/tl/eth/linuxeth.c */
 void XcpTl_Init(void) {
 }
+#endif /* XCP_TRANSPORT_LAYER */
 
 void XcpHw_Init(void) {
     printf("XcpHw_Init\n");
@@ -94,11 +130,13 @@ void XcpHw_ReleaseLock(uint8_t lockIdx) {
     }
 }
 
+#if XCP_TRANSPORT_LAYER != XCP_ON_ETHERNET
 void XcpTl_SaveConnection() {
 }
 
 void XcpTl_ReleaseConnection() {
 }
+#endif /* XCP_TRANSPORT_LAYER */
 
 void XcpHw_Sleep(uint64_t usec) {
     //    delayMicroseconds(usec);
@@ -130,10 +168,36 @@ uint16_t XcpTl_GetLastSend(uint8_t *buf, uint16_t max_len) {
     return last_send_len;
 }
 
+void XcpTl_ResetSent(void) {
+    XCP_TL_ENTER_CRITICAL();
+    sent_count = 0;
+    XCP_TL_LEAVE_CRITICAL();
+}
+
+uint16_t XcpTl_GetSentCount(void) {
+    return sent_count;
+}
+
+uint16_t XcpTl_GetSent(uint16_t idx, uint8_t *buf, uint16_t max_len) {
+    uint16_t copy_len;
+
+    if (idx >= sent_count) {
+        return 0;
+    }
+    copy_len = (sent_lens[idx] < max_len) ? sent_lens[idx] : max_len;
+    memcpy(buf, sent_frames[idx], copy_len);
+    return copy_len;
+}
+
+#if XCP_TRANSPORT_LAYER != XCP_ON_ETHERNET
 void XcpTl_Send(uint8_t const *buf, uint16_t len) {
     XCP_TL_ENTER_CRITICAL();
     last_send_len = (len < (uint16_t)sizeof(last_send)) ? len : (uint16_t)sizeof(last_send);
     memcpy(last_send, buf, last_send_len);
+    if (sent_count < MOCK_SENT_FRAMES) {
+        memcpy(sent_frames[sent_count], last_send, last_send_len);
+        sent_lens[sent_count++] = last_send_len;
+    }
     printf("Send: %d bytes [%p]\n", len, buf);
     Hexdump(buf, len);
     XCP_TL_LEAVE_CRITICAL();
@@ -141,11 +205,12 @@ void XcpTl_Send(uint8_t const *buf, uint16_t len) {
 
 void XcpTl_TransportLayerCmd_Res(Xcp_PduType const * const pdu) {
 }
+#endif /* XCP_TRANSPORT_LAYER */
 
-char *data_start() {
+char *mock_data_start() {
     return (char *)&start_marker;
 }
 
-char *data_end() {
+char *mock_data_end() {
     return (char *)&end_marker;
 }